@@ -0,0 +1,507 @@
+/**
+ * @file Contagem das alocações (só conta com -DCOUNT_ALLOCS e o --wrap do linker, ver o compile.txt)
+ */
+
+// Para o 'dladdr'
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocs.h"
+
+// O seguimento precisa da contagem
+#if defined(TRACK_ALLOCS) && !defined(COUNT_ALLOCS)
+#define COUNT_ALLOCS
+#endif
+
+/** Alocações feitas até agora */
+static long allocs_p_count = 0;
+/** Bytes pedidos até agora */
+static long allocs_p_bytes = 0;
+
+#ifdef COUNT_ALLOCS
+
+// Com '-Wl,--wrap=malloc' as chamadas ao malloc vão para o '__wrap_malloc', e o original fica '__real_malloc'
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+/** @brief Conta uma alocação.
+ * 
+ * @param size Bytes pedidos
+ */
+void allocs_p_Add(size_t size)
+{
+    __atomic_add_fetch(&allocs_p_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocs_p_bytes, (long)size, __ATOMIC_RELAXED);
+}
+
+#ifdef TRACK_ALLOCS
+
+/** Capacidade inicial da tabela dos blocos vivos (tem que ser uma potência de 2) */
+#define AllocsTableInitialSize 4096
+/** Capacidade da tabela dos sitios (tem que ser uma potência de 2) */
+#define AllocsSiteCount 4096
+/** Quantidade de sitios mostrados no relatório */
+#define AllocsReportSites 15
+/** Quantidade de tipos de items (um por cada bit do 'ItemType') */
+#define AllocsTypeCount 7
+
+void __real_free(void* pointer);
+
+/**
+ * Um bloco alocado que ainda não foi libertado
+ */
+typedef struct AllocsBlockT
+{
+    void* pointer;  /*!< Endereço do bloco (NULL nas posições vazias da tabela) */
+    size_t size;    /*!< Bytes pedidos */
+    void* site;     /*!< Endereço de onde foi chamado o malloc */
+} AllocsBlock;
+
+/**
+ * Valores de um sitio do código que aloca memória
+ */
+typedef struct AllocsSiteT
+{
+    void* site;     /*!< Endereço de onde foi chamado o malloc (NULL nas posições vazias, e nos sitios que não couberam) */
+    long count;     /*!< Alocações */
+    long bytes;     /*!< Bytes pedidos */
+    long live;      /*!< Blocos ainda vivos */
+    long liveBytes; /*!< Bytes ainda vivos */
+} AllocsSite;
+
+/** Protege as tabelas (as alocações podem vir de várias threads) */
+static pthread_mutex_t allocs_p_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Tabela dos blocos vivos (endereçamento aberto, com sondagem linear) */
+static AllocsBlock* allocs_p_blocks = NULL;
+/** Capacidade da tabela dos blocos */
+static size_t allocs_p_capacity = 0;
+/** Blocos na tabela */
+static size_t allocs_p_used = 0;
+/** Tabela dos sitios */
+static AllocsSite allocs_p_sites[AllocsSiteCount];
+/** Sitios na tabela */
+static int allocs_p_siteCount = 0;
+/** Sitios que já não couberam na tabela */
+static AllocsSite allocs_p_otherSite;
+/** Bytes vivos */
+static long allocs_p_live = 0;
+/** Maior valor do 'allocs_p_live' */
+static long allocs_p_peak = 0;
+/** Items criados de cada tipo */
+static long allocs_p_itemsCreated[AllocsTypeCount];
+/** Items vivos de cada tipo */
+static long allocs_p_itemsLive[AllocsTypeCount];
+/** Nome de cada tipo de item */
+static const char* allocs_p_typeNames[AllocsTypeCount] = { "long", "double", "char", "string", "list", "block", "repeat" };
+
+/** @brief Calcula a posição de um endereço numa tabela.
+ * 
+ * @param pointer Endereço
+ * @param mask Capacidade da tabela menos 1
+ * @returns Posição inicial
+ */
+size_t allocs_p_Hash(void* pointer, size_t mask)
+{ return (size_t)(((uintptr_t)pointer >> 4) * 0x9E3779B97F4A7C15ull) & mask; }
+
+/** @brief Procura (ou cria) os valores de um sitio.
+ * 
+ * @param site Endereço de onde foi chamado o malloc
+ * @returns Apontador para os valores
+ */
+AllocsSite* allocs_p_Site(void* site)
+{
+    size_t mask = AllocsSiteCount - 1;
+    for (size_t i = allocs_p_Hash(site, mask); ; i = (i + 1) & mask)
+    {
+        if (allocs_p_sites[i].site == site)
+            return &allocs_p_sites[i];
+        if (allocs_p_sites[i].site == NULL)
+        {
+            // A tabela nunca fica cheia, para a procura acabar sempre
+            if (allocs_p_siteCount == AllocsSiteCount - 1)
+                return &allocs_p_otherSite;
+            allocs_p_siteCount++;
+            allocs_p_sites[i].site = site;
+            return &allocs_p_sites[i];
+        }
+    }
+}
+
+/** @brief Retira da tabela o bloco na posição dada, puxando para trás os que vêm a seguir.
+ * 
+ * @param i Posição do bloco
+ */
+void allocs_p_RemoveAt(size_t i)
+{
+    size_t mask = allocs_p_capacity - 1;
+    AllocsBlock* block = &allocs_p_blocks[i];
+    AllocsSite* site = allocs_p_Site(block->site);
+    site->live--;
+    site->liveBytes -= block->size;
+    allocs_p_live -= block->size;
+    allocs_p_used--;
+    // Remoção sem marcas: os blocos seguintes que podiam estar nesta posição passam para ela
+    for (size_t j = (i + 1) & mask; allocs_p_blocks[j].pointer != NULL; j = (j + 1) & mask)
+    {
+        size_t home = allocs_p_Hash(allocs_p_blocks[j].pointer, mask);
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            allocs_p_blocks[i] = allocs_p_blocks[j];
+            i = j;
+        }
+    }
+    allocs_p_blocks[i].pointer = NULL;
+}
+
+/** @brief Procura a posição de um bloco, ou a posição vazia onde ficaria.
+ * 
+ * @param pointer Endereço do bloco
+ * @returns Posição
+ */
+size_t allocs_p_Find(void* pointer)
+{
+    size_t mask = allocs_p_capacity - 1, i = allocs_p_Hash(pointer, mask);
+    while (allocs_p_blocks[i].pointer != NULL && allocs_p_blocks[i].pointer != pointer)
+        i = (i + 1) & mask;
+    return i;
+}
+
+/** @brief Duplica a capacidade da tabela dos blocos.
+ */
+void allocs_p_Grow()
+{
+    AllocsBlock* old = allocs_p_blocks;
+    size_t oldCapacity = allocs_p_capacity;
+    allocs_p_capacity = oldCapacity ? oldCapacity * 2 : AllocsTableInitialSize;
+    allocs_p_blocks = __real_calloc(allocs_p_capacity, sizeof(AllocsBlock));
+    for (size_t i = 0; i < oldCapacity; i++)
+        if (old[i].pointer != NULL)
+            allocs_p_blocks[allocs_p_Find(old[i].pointer)] = old[i];
+    __real_free(old);
+}
+
+/** @brief Guarda um bloco novo.
+ * 
+ * @param pointer Endereço do bloco
+ * @param size Bytes pedidos
+ * @param site Endereço de onde foi chamado o malloc
+ */
+void allocs_p_Track(void* pointer, size_t size, void* site)
+{
+    pthread_mutex_lock(&allocs_p_lock);
+    if ((allocs_p_used + 1) * 2 > allocs_p_capacity)
+        allocs_p_Grow();
+    size_t i = allocs_p_Find(pointer);
+    // Um bloco com o mesmo endereço foi libertado sem passar por aqui (pela libc, por exemplo)
+    if (allocs_p_blocks[i].pointer != NULL)
+    {
+        allocs_p_RemoveAt(i);
+        i = allocs_p_Find(pointer);
+    }
+    allocs_p_blocks[i].pointer = pointer;
+    allocs_p_blocks[i].size = size;
+    allocs_p_blocks[i].site = site;
+    allocs_p_used++;
+    AllocsSite* s = allocs_p_Site(site);
+    s->count++;
+    s->bytes += size;
+    s->live++;
+    s->liveBytes += size;
+    allocs_p_live += size;
+    if (allocs_p_live > allocs_p_peak)
+        allocs_p_peak = allocs_p_live;
+    pthread_mutex_unlock(&allocs_p_lock);
+}
+
+/** @brief Esquece um bloco libertado (os que não estão na tabela, como os alocados pela libc, são ignorados).
+ * 
+ * @param pointer Endereço do bloco
+ */
+void allocs_p_Untrack(void* pointer)
+{
+    pthread_mutex_lock(&allocs_p_lock);
+    if (allocs_p_capacity > 0)
+    {
+        size_t i = allocs_p_Find(pointer);
+        if (allocs_p_blocks[i].pointer != NULL)
+            allocs_p_RemoveAt(i);
+    }
+    pthread_mutex_unlock(&allocs_p_lock);
+}
+
+/** @brief Conta um item criado ou libertado.
+ * 
+ * @param type Tipo do item (um dos valores do 'ItemType')
+ * @param delta 1 quando é criado, -1 quando é libertado
+ */
+void allocs_p_Item(int type, int delta)
+{
+    int t = __builtin_ctz(type);
+    if (delta > 0)
+        __atomic_add_fetch(&allocs_p_itemsCreated[t], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocs_p_itemsLive[t], delta, __ATOMIC_RELAXED);
+}
+
+/** @brief Conta a alocação, guarda o bloco e chama o malloc verdadeiro. */
+void* __wrap_malloc(size_t size)
+{
+    allocs_p_Add(size);
+    void* pointer = __real_malloc(size);
+    if (pointer != NULL)
+        allocs_p_Track(pointer, size, __builtin_return_address(0));
+    return pointer;
+}
+
+/** @brief Conta a alocação, guarda o bloco e chama o calloc verdadeiro. */
+void* __wrap_calloc(size_t count, size_t size)
+{
+    allocs_p_Add(count * size);
+    void* pointer = __real_calloc(count, size);
+    if (pointer != NULL)
+        allocs_p_Track(pointer, count * size, __builtin_return_address(0));
+    return pointer;
+}
+
+/** @brief Conta a alocação, troca o bloco e chama o realloc verdadeiro. */
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    allocs_p_Add(size);
+    void* new = __real_realloc(pointer, size);
+    // Se falhar o bloco antigo continua vivo (com o tamanho 0 é libertado)
+    if (pointer != NULL && (new != NULL || size == 0))
+        allocs_p_Untrack(pointer);
+    if (new != NULL)
+        allocs_p_Track(new, size, __builtin_return_address(0));
+    return new;
+}
+
+/** @brief Esquece o bloco e chama o free verdadeiro. */
+void __wrap_free(void* pointer)
+{
+    if (pointer != NULL)
+        allocs_p_Untrack(pointer);
+    __real_free(pointer);
+}
+
+#else
+
+/** @brief Conta a alocação e chama o malloc verdadeiro. */
+void* __wrap_malloc(size_t size)
+{
+    allocs_p_Add(size);
+    return __real_malloc(size);
+}
+
+/** @brief Conta a alocação e chama o calloc verdadeiro. */
+void* __wrap_calloc(size_t count, size_t size)
+{
+    allocs_p_Add(count * size);
+    return __real_calloc(count, size);
+}
+
+/** @brief Conta a alocação e chama o realloc verdadeiro. */
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    allocs_p_Add(size);
+    return __real_realloc(pointer, size);
+}
+
+#endif
+
+/** @brief Verifica se o programa foi compilado com a contagem das alocações.
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Enabled()
+{ return 1; }
+
+#else
+
+/** @brief Verifica se o programa foi compilado com a contagem das alocações.
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Enabled()
+{ return 0; }
+
+#endif
+
+/** @brief Dá a quantidade de alocações (malloc, calloc e realloc) feitas até agora, em todas as threads.
+ * 
+ * @returns Quantidade de alocações (sempre 0 sem a contagem)
+ */
+long allocs_Count()
+{ return __atomic_load_n(&allocs_p_count, __ATOMIC_RELAXED); }
+
+/** @brief Dá o total de bytes pedidos nas alocações feitas até agora, em todas as threads.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem a contagem)
+ */
+long allocs_Bytes()
+{ return __atomic_load_n(&allocs_p_bytes, __ATOMIC_RELAXED); }
+
+#ifdef TRACK_ALLOCS
+
+/** @brief Verifica se o programa foi compilado com o seguimento das alocações (-DTRACK_ALLOCS).
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Tracking()
+{ return 1; }
+
+/** @brief Dá os bytes alocados que ainda não foram libertados.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Live()
+{
+    pthread_mutex_lock(&allocs_p_lock);
+    long live = allocs_p_live;
+    pthread_mutex_unlock(&allocs_p_lock);
+    return live;
+}
+
+/** @brief Dá o maior valor que o 'allocs_Live' teve até agora.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Peak()
+{
+    pthread_mutex_lock(&allocs_p_lock);
+    long peak = allocs_p_peak;
+    pthread_mutex_unlock(&allocs_p_lock);
+    return peak;
+}
+
+/** @brief Escreve o nome de um sitio (a função e o deslocamento, se o executável tiver os símbolos).
+ * 
+ * @param site Endereço de onde foi chamado o malloc
+ * @param out Ficheiro onde se escreve
+ */
+void allocs_p_PrintSite(void* site, FILE* out)
+{
+    Dl_info info;
+    char name[64];
+    if (site == NULL)
+        snprintf(name, sizeof(name), "(other)");
+    else if (dladdr(site, &info) && info.dli_sname != NULL)
+        snprintf(name, sizeof(name), "%s+0x%lx", info.dli_sname, (unsigned long)((char*)site - (char*)info.dli_saddr));
+    else snprintf(name, sizeof(name), "%p", site);
+    fprintf(out, "%-40s", name);
+}
+
+/** Campo usado para ordenar os sitios */
+static int allocs_p_sortByLive = 0;
+
+/** @brief Compara dois sitios pelos bytes (ou pelos bytes vivos), o maior primeiro, para o qsort.
+ * 
+ * @param a Apontador para o primeiro
+ * @param b Apontador para o segundo
+ * @returns Negativo, zero ou positivo
+ */
+int allocs_p_CompareSites(const void* a, const void* b)
+{
+    const AllocsSite* x = (const AllocsSite*)a, *y = (const AllocsSite*)b;
+    long vx = allocs_p_sortByLive ? x->liveBytes : x->bytes, vy = allocs_p_sortByLive ? y->liveBytes : y->bytes;
+    return (vx < vy) - (vx > vy);
+}
+
+/** @brief Escreve os sitios com mais bytes (ou mais bytes vivos).
+ * 
+ * @param sites Sitios
+ * @param n Quantidade de sitios
+ * @param byLive 1 para ordenar pelos bytes vivos (e só mostrar os que têm blocos vivos)
+ * @param out Ficheiro onde se escreve
+ */
+void allocs_p_PrintSites(AllocsSite* sites, int n, int byLive, FILE* out)
+{
+    allocs_p_sortByLive = byLive;
+    qsort(sites, n, sizeof(AllocsSite), allocs_p_CompareSites);
+    fprintf(out, "%-40s %12s %14s %10s %14s\n", byLive ? "leaked at" : "site", "allocs", "bytes", "live", "live_bytes");
+    for (int i = 0, shown = 0; i < n && shown < AllocsReportSites; i++)
+    {
+        if (byLive && sites[i].live == 0)
+            continue;
+        allocs_p_PrintSite(sites[i].site, out);
+        fprintf(out, " %12ld %14ld %10ld %14ld\n", sites[i].count, sites[i].bytes, sites[i].live, sites[i].liveBytes);
+        shown++;
+    }
+    fprintf(out, "\n");
+}
+
+/** @brief Escreve o relatório das alocações: totais, sitios que mais alocaram, items por tipo e o que ainda está vivo.
+ * 
+ * No fim do programa (depois de tudo ser libertado) o que ainda está vivo são as fugas de memória.
+ * 
+ * @param out Ficheiro onde se escreve
+ */
+void allocs_Report(FILE* out)
+{
+    // Uma cópia dos sitios, para não escrever com o lock
+    pthread_mutex_lock(&allocs_p_lock);
+    AllocsSite* sites = __real_malloc((AllocsSiteCount + 1) * sizeof(AllocsSite));
+    int n = 0;
+    for (int i = 0; i < AllocsSiteCount; i++)
+        if (allocs_p_sites[i].site != NULL)
+            sites[n++] = allocs_p_sites[i];
+    if (allocs_p_otherSite.count > 0)
+        sites[n++] = allocs_p_otherSite;
+    long live = allocs_p_live, peak = allocs_p_peak, blocks = (long)allocs_p_used;
+    pthread_mutex_unlock(&allocs_p_lock);
+
+    fprintf(out, "allocs: count=%ld bytes=%ld live_bytes=%ld live_blocks=%ld peak_bytes=%ld\n\n",
+        allocs_Count(), allocs_Bytes(), live, blocks, peak);
+    allocs_p_PrintSites(sites, n, 0, out);
+    fprintf(out, "%-40s %12s %10s\n", "item type", "created", "live");
+    for (int t = 0; t < AllocsTypeCount; t++)
+        fprintf(out, "%-40s %12ld %10ld\n", allocs_p_typeNames[t],
+            __atomic_load_n(&allocs_p_itemsCreated[t], __ATOMIC_RELAXED), __atomic_load_n(&allocs_p_itemsLive[t], __ATOMIC_RELAXED));
+    fprintf(out, "\n");
+    if (blocks > 0)
+        allocs_p_PrintSites(sites, n, 1, out);
+    else fprintf(out, "no leaks\n");
+    __real_free(sites);
+}
+
+#else
+
+/** @brief Verifica se o programa foi compilado com o seguimento das alocações (-DTRACK_ALLOCS).
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Tracking()
+{ return 0; }
+
+/** @brief Dá os bytes alocados que ainda não foram libertados.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Live()
+{ return 0; }
+
+/** @brief Dá o maior valor que o 'allocs_Live' teve até agora.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Peak()
+{ return 0; }
+
+/** @brief Escreve o relatório das alocações: totais, sitios que mais alocaram, items por tipo e o que ainda está vivo.
+ * 
+ * No fim do programa (depois de tudo ser libertado) o que ainda está vivo são as fugas de memória.
+ * 
+ * @param out Ficheiro onde se escreve
+ */
+void allocs_Report(FILE* out)
+{ fprintf(out, "allocs: tracking is off (compile with -DTRACK_ALLOCS, see compile.txt)\n"); }
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file Contagem das alocações (só conta com -DCOUNT_ALLOCS e o --wrap do linker, ver o compile.txt)
+ * 
+ * Com -DTRACK_ALLOCS (e também o --wrap=free) cada bloco vivo é seguido: ficam a saber-se os
+ * bytes vivos, o pico, as alocações de cada sitio do código, os items de cada tipo e o que
+ * ficou por libertar no fim.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+/** @brief Verifica se o programa foi compilado com a contagem das alocações.
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Enabled();
+
+/** @brief Dá a quantidade de alocações (malloc, calloc e realloc) feitas até agora, em todas as threads.
+ * 
+ * @returns Quantidade de alocações (sempre 0 sem a contagem)
+ */
+long allocs_Count();
+
+/** @brief Dá o total de bytes pedidos nas alocações feitas até agora, em todas as threads.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem a contagem)
+ */
+long allocs_Bytes();
+
+/** @brief Verifica se o programa foi compilado com o seguimento das alocações (-DTRACK_ALLOCS).
+ * 
+ * @returns 1 ou 0
+ */
+int allocs_Tracking();
+
+/** @brief Dá os bytes alocados que ainda não foram libertados.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Live();
+
+/** @brief Dá o maior valor que o 'allocs_Live' teve até agora.
+ * 
+ * @returns Quantidade de bytes (sempre 0 sem o seguimento)
+ */
+long allocs_Peak();
+
+/** @brief Escreve o relatório das alocações: totais, sitios que mais alocaram, items por tipo e o que ainda está vivo.
+ * 
+ * No fim do programa (depois de tudo ser libertado) o que ainda está vivo são as fugas de memória.
+ * 
+ * @param out Ficheiro onde se escreve
+ */
+void allocs_Report(FILE* out);
+
+#ifdef TRACK_ALLOCS
+
+/** @brief Conta um item criado ou libertado.
+ * 
+ * @param type Tipo do item (um dos valores do 'ItemType')
+ * @param delta 1 quando é criado, -1 quando é libertado
+ */
+void allocs_p_Item(int type, int delta);
+
+/** Conta um item criado (sem o seguimento não faz nada) */
+#define allocs_ItemCreated(type) allocs_p_Item((type), 1)
+/** Conta um item libertado (sem o seguimento não faz nada) */
+#define allocs_ItemDisposed(type) allocs_p_Item((type), -1)
+
+#else
+
+/** Conta um item criado (sem o seguimento não faz nada) */
+#define allocs_ItemCreated(type) ((void)0)
+/** Conta um item libertado (sem o seguimento não faz nada) */
+#define allocs_ItemDisposed(type) ((void)0)
+
+#endif
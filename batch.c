@@ -0,0 +1,139 @@
+/**
+ * @file Modo batch: corre vários programas independentes, cada um com a sua entrada, pelas threads
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "interp.h"
+#include "parser.h"
+#include "pool.h"
+#include "utils.h"
+
+/** @brief Divide o texto do ficheiro nos trabalhos.
+ * 
+ * @param text Texto do ficheiro
+ * @param size Tamanho do texto
+ * @param count Out: Quantidade de trabalhos
+ * @returns Array com os trabalhos (os textos são cópias)
+ */
+BatchJob* batch_p_Parse(char* text, int size, int* count)
+{
+    int capacity = 16;
+    BatchJob* jobs = malloc(capacity * sizeof(BatchJob));
+    int separatorSize = strlen(BatchSeparator);
+    *count = 0;
+    int pos = 0;
+    while (pos < size)
+    {
+        // Fim do trabalho: a próxima linha só com o separador (ou o fim do ficheiro)
+        int end = pos, next = size;
+        while (end < size)
+        {
+            int lineEnd = end;
+            while (lineEnd < size && text[lineEnd] != '\n')
+                lineEnd++;
+            if (lineEnd - end == separatorSize && strncmp(text + end, BatchSeparator, separatorSize) == 0)
+            {
+                next = (lineEnd < size) ? lineEnd + 1 : size;
+                break;
+            }
+            end = (lineEnd < size) ? lineEnd + 1 : size;
+        }
+        if (end > pos)
+        {
+            if (*count == capacity)
+            {
+                capacity *= 2;
+                jobs = realloc(jobs, capacity * sizeof(BatchJob));
+            }
+            BatchJob* job = &jobs[(*count)++];
+            int programEnd = pos;
+            while (programEnd < end && text[programEnd] != '\n')
+                programEnd++;
+            int inputStart = (programEnd < end) ? programEnd + 1 : end;
+            job->programSize = programEnd - pos;
+            job->program = utils_Substring(text + pos, job->programSize);
+            job->inputSize = end - inputStart;
+            job->input = utils_Substring(text + inputStart, job->inputSize);
+            job->output = NULL;
+            job->outputSize = 0;
+        }
+        pos = next;
+    }
+    return jobs;
+}
+
+/** @brief Corre um trabalho com um stack, variáveis e canais só seus.
+ * 
+ * @param context Array com os trabalhos
+ * @param chunk Indice do trabalho
+ * @param worker Indice da thread (não é usado)
+ */
+void batch_p_RunJob(void* context, int chunk, int worker)
+{
+    (void)worker;
+    BatchJob* job = &((BatchJob*)context)[chunk];
+    FILE* in = fmemopen(job->input, job->inputSize, "r");
+    FILE* out = open_memstream(&job->output, &job->outputSize);
+    Interp* ip = interp_Create(in, out);
+    if (job->programSize > 0 && job->program[0] == 'z')
+        parser_DebugProcess(ip, job->program + 1, job->programSize - 1);
+    else parser_Process(ip, job->program, job->programSize);
+    stack_Print(ip->stack, out);
+    putc('\n', out);
+    interp_Dispose(ip);
+    fclose(in);
+    fclose(out);
+}
+
+/** @brief Corre todos os trabalhos de um ficheiro e escreve as saídas pela ordem dos trabalhos.
+ * 
+ * O ficheiro tem um trabalho atrás do outro, separados por linhas só com "%%".
+ * A primeira linha de cada trabalho é o programa e as restantes são a sua entrada.
+ * Cada trabalho tem o seu interpretador (stack, variáveis e canais), e os trabalhos
+ * são divididos pelas threads da pool partilhada (se o modo paralelo estiver ligado).
+ * 
+ * @param path Caminho do ficheiro
+ * @param out Ficheiro onde se escrevem as saídas
+ * @returns 0 se correu tudo, 1 se o ficheiro não pode ser lido
+ */
+int batch_Run(char* path, FILE* out)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Can't open batch file '%s'\n", path);
+        return 1;
+    }
+    int size; char* text = utils_GetAllLines(file, &size);
+    fclose(file);
+
+    int count;
+    BatchJob* jobs = batch_p_Parse(text != NULL ? text : "", size, &count);
+    free(text);
+
+    // Os blocos dentro de cada trabalho correm em série enquanto a pool está ocupada com os trabalhos.
+    // Os trabalhos correm aos grupos, e as saídas de cada grupo são escritas e libertadas antes do
+    // seguinte, para a memória não crescer com a quantidade de trabalhos
+    Pool* pool = pool_Default();
+    for (int start = 0; start < count; start += BatchWindowSize)
+    {
+        int n = (count - start < BatchWindowSize) ? count - start : BatchWindowSize;
+        if (pool != NULL)
+            pool_Run(pool, n, batch_p_RunJob, jobs + start);
+        else for (int i = 0; i < n; i++)
+            batch_p_RunJob(jobs + start, i, 0);
+        for (int i = start; i < start + n; i++)
+        {
+            fwrite(jobs[i].output, sizeof(char), jobs[i].outputSize, out);
+            free(jobs[i].program);
+            free(jobs[i].input);
+            free(jobs[i].output);
+        }
+    }
+    free(jobs);
+    return 0;
+}
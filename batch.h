@@ -0,0 +1,39 @@
+/**
+ * @file Modo batch: corre vários programas independentes, cada um com a sua entrada, pelas threads
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+/** Linha que separa os trabalhos no ficheiro do batch */
+#define BatchSeparator "%%"
+/** Quantidade de trabalhos que correm antes de as suas saídas serem escritas */
+#define BatchWindowSize 64
+
+/**
+ * Um trabalho do batch: um programa, a sua entrada e a saída que produziu.
+ */
+typedef struct BatchJobT
+{
+    char* program;      /*!< Linha do programa (tal como seria lida da 'stdin') */
+    int programSize;    /*!< Tamanho do programa */
+    char* input;        /*!< Entrada lida pelo 'l' e pelo 't' */
+    int inputSize;      /*!< Tamanho da entrada */
+    char* output;       /*!< Saída do programa (criada ao correr) */
+    size_t outputSize;  /*!< Tamanho da saída */
+} BatchJob;
+
+
+/** @brief Corre todos os trabalhos de um ficheiro e escreve as saídas pela ordem dos trabalhos.
+ * 
+ * O ficheiro tem um trabalho atrás do outro, separados por linhas só com "%%".
+ * A primeira linha de cada trabalho é o programa e as restantes são a sua entrada.
+ * Cada trabalho tem o seu interpretador (stack, variáveis e canais), e os trabalhos
+ * são divididos pelas threads da pool partilhada (se o modo paralelo estiver ligado).
+ * 
+ * @param path Caminho do ficheiro
+ * @param out Ficheiro onde se escrevem as saídas
+ * @returns 0 se correu tudo, 1 se o ficheiro não pode ser lido
+ */
+int batch_Run(char* path, FILE* out);
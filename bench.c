@@ -0,0 +1,613 @@
+/**
+ * @file Microbenchmarks de cada família de operadores (só é compilado com -DBENCH, ver o compile.txt)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "allocs.h"
+#include "handler_array.h"
+#include "handler_math.h"
+#include "interp.h"
+#include "parser.h"
+#include "vm.h"
+
+#ifdef BENCH
+
+/** Tamanhos das entradas usados em todos os benchmarks */
+#define BenchSizeCount 4
+/** Tempo medido por omissão em cada benchmark e tamanho (em milissegundos) */
+#define BenchDefaultTime 200
+/** Limite do tempo total (com a preparação dos dados) de cada benchmark e tamanho, em múltiplos do tempo medido */
+#define BenchWallFactor 5
+/** Quantidade de tamanhos (cada um o dobro do anterior) medidos em cada operador no modo --complexity */
+#define ComplexitySizeCount 8
+/** Tempo medido por omissão em cada operador e tamanho no modo --complexity (em milissegundos) */
+#define ComplexityDefaultTime 50
+/**
+ * Diferença máxima aceite entre o expoente medido e o declarado (metade da distância entre
+ * duas classes, porque as caches e o malloc fazem o expoente medido subir um pouco nos tamanhos grandes)
+ */
+#define ComplexityTolerance 0.5
+
+/**
+ * Estado de uma medição. O relógio e a contagem das alocações só contam entre
+ * 'bench_p_Resume' e 'bench_p_Pause', para a preparação dos dados não contar.
+ */
+typedef struct BenchT
+{
+    struct timespec started;    /*!< Quando a medição foi retomada */
+    long elapsed;               /*!< Nanosegundos medidos até agora */
+    long allocs;                /*!< Alocações feitas nas partes medidas */
+    long bytes;                 /*!< Bytes pedidos nas partes medidas */
+    long startAllocs;           /*!< Alocações quando a medição foi retomada */
+    long startBytes;            /*!< Bytes quando a medição foi retomada */
+    Interp* ip;                 /*!< Interpretador usado pelos handlers */
+} Bench;
+
+/** Função que executa uma iteração de um benchmark e devolve quantas operações fez */
+typedef long (*BenchCase)(Bench* b, int size);
+
+/**
+ * Um benchmark da tabela
+ */
+typedef struct BenchEntryT
+{
+    char* name;         /*!< Nome (família_caso) */
+    BenchCase run;      /*!< Função do benchmark */
+} BenchEntry;
+
+/**
+ * Um operador verificado no modo --complexity
+ */
+typedef struct ComplexityEntryT
+{
+    char* name;         /*!< Nome do operador */
+    BenchCase run;      /*!< Função que executa o operador uma vez com uma entrada do tamanho dado */
+    double exponent;    /*!< Expoente declarado (0 para O(1), 1 para O(n), ...) */
+    int minSize;        /*!< Primeiro tamanho medido */
+} ComplexityEntry;
+
+/** Tamanhos das entradas */
+static const int bench_p_sizes[BenchSizeCount] = { 16, 256, 4096, 65536 };
+
+
+// Medição
+
+/** @brief Retoma o relógio e a contagem das alocações.
+ * 
+ * @param b Apontador para a medição
+ */
+void bench_p_Resume(Bench* b)
+{
+    b->startAllocs = allocs_Count();
+    b->startBytes = allocs_Bytes();
+    clock_gettime(CLOCK_MONOTONIC, &b->started);
+}
+
+/** @brief Pára o relógio e a contagem das alocações.
+ * 
+ * @param b Apontador para a medição
+ */
+void bench_p_Pause(Bench* b)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    b->allocs += allocs_Count() - b->startAllocs;
+    b->bytes += allocs_Bytes() - b->startBytes;
+    b->elapsed += (now.tv_sec - b->started.tv_sec) * 1000000000L + (now.tv_nsec - b->started.tv_nsec);
+}
+
+/** @brief Cria uma string com palavras de uma letra separadas por espaços.
+ * 
+ * @param size Tamanho da string
+ * @returns Item com a string
+ */
+Item* bench_p_Words(int size)
+{
+    char* s = malloc(size + 1);
+    for (int i = 0; i < size; i++)
+        s[i] = (i % 2) ? ' ' : 'a' + (i / 2) % 26;
+    s[size] = '\0';
+    return icreate_String(s, size);
+}
+
+/** @brief Cria uma lista com os números de 0 a size - 1.
+ * 
+ * @param size Tamanho da lista
+ * @returns Item com a lista
+ */
+Item* bench_p_Range(int size)
+{
+    List* list = list_Create(size);
+    for (int i = 0; i < size; i++)
+        list_Add(list, icreate_Long(i));
+    return icreate_FromList(list);
+}
+
+/** @brief Esvazia o stack do interpretador.
+ * 
+ * @param b Apontador para a medição
+ */
+void bench_p_Clear(Bench* b)
+{
+    stack_Clear(b->ip->stack);
+}
+
+
+// Benchmarks
+
+/** @brief stack_Push e stack_Pop de items já criados. */
+long bench_p_PushPop(Bench* b, int size)
+{
+    Item** items = malloc(size * sizeof(Item*));
+    for (int i = 0; i < size; i++)
+        items[i] = icreate_Long(i);
+    Stack* stack = b->ip->stack;
+    bench_p_Resume(b);
+    for (int i = 0; i < size; i++)
+        stack_Push(stack, items[i]);
+    for (int i = 0; i < size; i++)
+        items[i] = stack_Pop(stack);
+    bench_p_Pause(b);
+    for (int i = 0; i < size; i++)
+        item_Dispose(items[i]);
+    free(items);
+    return size;
+}
+
+/** @brief Aplica o mesmo comando de 'hHub_Math' a uma cadeia de números.
+ * 
+ * @param b Apontador para a medição
+ * @param size Quantidade de números
+ * @param cmd Comando
+ * @param real 1 para usar doubles, 0 para longs
+ * @returns Quantidade de operações
+ */
+long bench_p_MathChain(Bench* b, int size, char cmd, int real)
+{
+    for (int i = 0; i < size; i++)
+        stack_Push(b->ip->stack, real ? icreate_Double(i + 1.5) : icreate_Long(i + 1));
+    bench_p_Resume(b);
+    for (int i = 1; i < size; i++)
+        hHub_Math(b->ip, cmd);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    return size - 1;
+}
+
+/** @brief hHub_Math '+' com longs. */
+long bench_p_MathAdd(Bench* b, int size) { return bench_p_MathChain(b, size, '+', 0); }
+/** @brief hHub_Math '*' com longs. */
+long bench_p_MathMult(Bench* b, int size) { return bench_p_MathChain(b, size, '*', 0); }
+/** @brief hHub_Math '|' com longs. */
+long bench_p_MathOr(Bench* b, int size) { return bench_p_MathChain(b, size, '|', 0); }
+/** @brief hHub_Math '+' com doubles. */
+long bench_p_MathAddDouble(Bench* b, int size) { return bench_p_MathChain(b, size, '+', 1); }
+/** @brief hHub_Math '/' com doubles. */
+long bench_p_MathDivDouble(Bench* b, int size) { return bench_p_MathChain(b, size, '/', 1); }
+
+/** @brief Executa um comando de 'hHub_Array' sobre dois items e liberta o resultado.
+ * 
+ * @param b Apontador para a medição
+ * @param ia Item de baixo
+ * @param ib Item do topo
+ * @param cmd Comando
+ * @returns 1 operação
+ */
+long bench_p_ArrayOp(Bench* b, Item* ia, Item* ib, char cmd)
+{
+    stack_Push(b->ip->stack, ia);
+    stack_Push(b->ip->stack, ib);
+    bench_p_Resume(b);
+    hHub_Array(b->ip, cmd);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    return 1;
+}
+
+/** @brief h_a_Concat de duas strings. */
+long bench_p_ConcatStrings(Bench* b, int size) { return bench_p_ArrayOp(b, bench_p_Words(size), bench_p_Words(size), '+'); }
+/** @brief h_a_Concat de duas listas. */
+long bench_p_ConcatLists(Bench* b, int size) { return bench_p_ArrayOp(b, bench_p_Range(size), bench_p_Range(size), '+'); }
+/** @brief h_a_Concat de uma lista e um número. */
+long bench_p_ConcatItem(Bench* b, int size) { return bench_p_ArrayOp(b, bench_p_Range(size), icreate_Long(7), '+'); }
+
+/** @brief h_a_SplitString com um espaço como separador. */
+long bench_p_SplitString(Bench* b, int size)
+{
+    char* separator = malloc(2);
+    strcpy(separator, " ");
+    return bench_p_ArrayOp(b, bench_p_Words(size), icreate_String(separator, 1), '/');
+}
+
+/** @brief Um array literal ('[' ... ']') com size números, já compilado. */
+long bench_p_ArrayLiteral(Bench* b, int size)
+{
+    char* text = malloc(size * 8 + 3);
+    int length = 0;
+    text[length++] = '[';
+    for (int i = 0; i < size; i++)
+        length += sprintf(text + length, "%d ", i % 1000);
+    text[length++] = ']';
+    text[length] = '\0';
+    Line* line = line_Create(text, length);
+    Code* code = parser_Compile(line, 0, length);
+    line_Dispose(line);
+    bench_p_Resume(b);
+    vm_Run(b->ip, code);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    code_Dispose(code);
+    free(text);
+    return 1;
+}
+
+/** @brief Executa um programa com o mesmo pedaço repetido size vezes, já compilado (mede o despacho da VM).
+ * 
+ * @param b Apontador para a medição
+ * @param size Quantidade de repetições
+ * @param unit Pedaço do programa (deve deixar o stack como estava)
+ * @returns Quantidade de instruções executadas
+ */
+long bench_p_Program(Bench* b, int size, char* unit)
+{
+    int unitLength = strlen(unit);
+    char* text = malloc(size * unitLength + 1);
+    for (int i = 0; i < size; i++)
+        memcpy(text + i * unitLength, unit, unitLength);
+    text[size * unitLength] = '\0';
+    Line* line = line_Create(text, size * unitLength);
+    Code* code = parser_Compile(line, 0, size * unitLength);
+    line_Dispose(line);
+    bench_p_Resume(b);
+    vm_Run(b->ip, code);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    long ops = code->count;
+    code_Dispose(code);
+    free(text);
+    return ops;
+}
+
+/** @brief Números e comandos aritméticos (os de 'hHub_Math'). */
+long bench_p_VmMath(Bench* b, int size) { return bench_p_Program(b, size, "1 2 + 3 * 4 - ; "); }
+/** @brief Comandos de 'hHub_Stack'. */
+long bench_p_VmStack(Bench* b, int size) { return bench_p_Program(b, size, "1 _ 2 \\ ; ; ; "); }
+/** @brief Variáveis, comparações e comandos começados por 'e'. */
+long bench_p_VmMixed(Bench* b, int size) { return bench_p_Program(b, size, "A B < ; X Y = ; 1 2 e< ; 3 ) ; "); }
+
+/** @brief item_Copy e item_Dispose do mesmo item, size vezes.
+ * 
+ * @param b Apontador para a medição
+ * @param item Item a copiar (é libertado no fim)
+ * @param size Quantidade de cópias
+ * @returns Quantidade de operações
+ */
+long bench_p_Copy(Bench* b, Item* item, int size)
+{
+    bench_p_Resume(b);
+    for (int i = 0; i < size; i++)
+        item_Dispose(item_Copy(item));
+    bench_p_Pause(b);
+    item_Dispose(item);
+    return size;
+}
+
+/** @brief item_Copy de um long. */
+long bench_p_CopyLong(Bench* b, int size) { return bench_p_Copy(b, icreate_Long(42), size); }
+/** @brief item_Copy de uma string com 64 chars. */
+long bench_p_CopyString(Bench* b, int size) { return bench_p_Copy(b, bench_p_Words(64), size); }
+/** @brief item_Copy de uma lista com 64 longs. */
+long bench_p_CopyList(Bench* b, int size) { return bench_p_Copy(b, bench_p_Range(64), size); }
+
+/** @brief stack_Print de um stack com size items (longs e strings alternados) para /dev/null. */
+long bench_p_Print(Bench* b, int size)
+{
+    for (int i = 0; i < size; i++)
+        stack_Push(b->ip->stack, (i % 2) ? bench_p_Words(8) : icreate_Long(i * 37));
+    bench_p_Resume(b);
+    stack_Print(b->ip->stack, b->ip->io.out);
+    fflush(b->ip->io.out);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    return size;
+}
+
+/** Tabela com todos os benchmarks */
+static const BenchEntry bench_p_entries[] =
+{
+    { "stack_pushpop", bench_p_PushPop },
+    { "math_add", bench_p_MathAdd },
+    { "math_mult", bench_p_MathMult },
+    { "math_or", bench_p_MathOr },
+    { "math_add_double", bench_p_MathAddDouble },
+    { "math_div_double", bench_p_MathDivDouble },
+    { "concat_strings", bench_p_ConcatStrings },
+    { "concat_lists", bench_p_ConcatLists },
+    { "concat_item", bench_p_ConcatItem },
+    { "split_string", bench_p_SplitString },
+    { "array_literal", bench_p_ArrayLiteral },
+    { "copy_long", bench_p_CopyLong },
+    { "copy_string", bench_p_CopyString },
+    { "copy_list", bench_p_CopyList },
+    { "stack_print", bench_p_Print },
+    { "vm_math", bench_p_VmMath },
+    { "vm_stack", bench_p_VmStack },
+    { "vm_mixed", bench_p_VmMixed },
+};
+
+
+// Complexidade
+
+/** @brief Executa um comando de 'hHub_Array' sobre um item e liberta o resultado.
+ * 
+ * @param b Apontador para a medição
+ * @param item Item
+ * @param cmd Comando
+ * @returns 1 operação
+ */
+long bench_p_ArrayOp1(Bench* b, Item* item, char cmd)
+{
+    stack_Push(b->ip->stack, item);
+    bench_p_Resume(b);
+    hHub_Array(b->ip, cmd);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    return 1;
+}
+
+/** @brief h_a_First numa string. */
+long bench_p_FirstString(Bench* b, int size) { return bench_p_ArrayOp1(b, bench_p_Words(size), '('); }
+/** @brief h_a_First numa lista. */
+long bench_p_FirstList(Bench* b, int size) { return bench_p_ArrayOp1(b, bench_p_Range(size), '('); }
+/** @brief Esvazia uma string ou lista com size comandos seguidos (cada elemento tirado é libertado).
+ * 
+ * @param b Apontador para a medição
+ * @param item String ou lista com size elementos
+ * @param size Quantidade de comandos
+ * @param cmd Comando
+ * @returns Quantidade de operações
+ */
+long bench_p_Drain(Bench* b, Item* item, int size, char cmd)
+{
+    stack_Push(b->ip->stack, item);
+    bench_p_Resume(b);
+    for (int i = 0; i < size; i++)
+    {
+        hHub_Array(b->ip, cmd);
+        item_Dispose(stack_Pop(b->ip->stack));
+    }
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    return size;
+}
+
+/** @brief Esvazia uma string com o h_a_Last. */
+long bench_p_LastString(Bench* b, int size) { return bench_p_Drain(b, bench_p_Words(size), size, ')'); }
+/** @brief Esvazia uma lista com o h_a_Last. */
+long bench_p_LastList(Bench* b, int size) { return bench_p_Drain(b, bench_p_Range(size), size, ')'); }
+
+/** @brief Constrói uma string com size '+' seguidos, cada um a juntar um char. */
+long bench_p_StringBuild(Bench* b, int size)
+{
+    Item** items = malloc(size * sizeof(Item*));
+    for (int i = 0; i < size; i++)
+    {
+        char* s = malloc(2);
+        strcpy(s, "x");
+        items[i] = icreate_String(s, 1);
+    }
+    stack_Push(b->ip->stack, icreate_String(calloc(1, 1), 0));
+    bench_p_Resume(b);
+    for (int i = 0; i < size; i++)
+    {
+        stack_Push(b->ip->stack, items[i]);
+        hHub_Array(b->ip, '+');
+    }
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    free(items);
+    return size;
+}
+
+/** @brief Adiciona size items a uma lista com o list_Add (passa pelo list_p_AssureSizeN). */
+long bench_p_ListAppend(Bench* b, int size)
+{
+    Item** items = malloc(size * sizeof(Item*));
+    for (int i = 0; i < size; i++)
+        items[i] = icreate_Long(i);
+    bench_p_Resume(b);
+    List* list = list_Create(ListInitialSize);
+    for (int i = 0; i < size; i++)
+        list_Add(list, items[i]);
+    bench_p_Pause(b);
+    list_Dispose(list);
+    free(items);
+    return size;
+}
+
+/** @brief Compila e executa size arrays encaixados ('[[[...]]]'). */
+long bench_p_ArrayNesting(Bench* b, int size)
+{
+    char* text = malloc(size * 2 + 1);
+    memset(text, '[', size);
+    memset(text + size, ']', size);
+    text[size * 2] = '\0';
+    bench_p_Resume(b);
+    Line* line = line_Create(text, size * 2);
+    Code* code = parser_Compile(line, 0, size * 2);
+    line_Dispose(line);
+    vm_Run(b->ip, code);
+    bench_p_Pause(b);
+    bench_p_Clear(b);
+    code_Dispose(code);
+    free(text);
+    return 1;
+}
+
+/** Tabela com os operadores verificados e a complexidade declarada de cada um */
+static const ComplexityEntry bench_p_complexity[] =
+{
+    { "first_string", bench_p_FirstString, 1, 2048 },
+    { "first_list", bench_p_FirstList, 1, 2048 },
+    { "last_string_drain", bench_p_LastString, 1, 2048 },
+    { "last_list_drain", bench_p_LastList, 1, 2048 },
+    { "string_build", bench_p_StringBuild, 1, 2048 },
+    { "list_append", bench_p_ListAppend, 1, 2048 },
+    { "array_nesting", bench_p_ArrayNesting, 1, 512 },
+};
+
+/** @brief Compara dois doubles (para o qsort).
+ * 
+ * @param a Apontador para o primeiro
+ * @param b Apontador para o segundo
+ * @returns Negativo, zero ou positivo
+ */
+int bench_p_CompareDoubles(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Mede um operador em tamanhos crescentes e verifica a sua complexidade.
+ * 
+ * Em cada tamanho conta o menor tempo de uma execução (o menos afetado pelo ruído). O expoente
+ * é a mediana dos declives entre cada par de pontos (log n, log tempo), que ao contrário dos
+ * mínimos quadrados não se deixa levar por um tamanho que saia das caches.
+ * 
+ * @param entry Operador
+ * @param ip Interpretador usado pelos handlers
+ * @param time Tempo a medir em cada tamanho (em nanosegundos)
+ * @returns 1 se o expoente medido não passar do declarado mais a tolerância
+ */
+int bench_p_MeasureComplexity(const ComplexityEntry* entry, Interp* ip, long time)
+{
+    Bench b;
+    b.ip = ip;
+    double x[ComplexitySizeCount], y[ComplexitySizeCount];
+    double slopes[ComplexitySizeCount * (ComplexitySizeCount - 1) / 2];
+    int n = 0;
+    for (int s = 0; s < ComplexitySizeCount; s++)
+    {
+        int size = entry->minSize << s;
+        long best = -1;
+        struct timespec start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        long wall = 0;
+        for (long total = 0; total < time && wall < time * BenchWallFactor; )
+        {
+            b.elapsed = 0;
+            b.allocs = 0;
+            b.bytes = 0;
+            entry->run(&b, size);
+            total += b.elapsed;
+            if (best < 0 || b.elapsed < best)
+                best = b.elapsed;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            wall = (now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec);
+        }
+        x[s] = log((double)size);
+        y[s] = log(best > 0 ? (double)best : 1.0);
+        for (int p = 0; p < s; p++)
+            slopes[n++] = (y[s] - y[p]) / (x[s] - x[p]);
+    }
+    qsort(slopes, n, sizeof(double), bench_p_CompareDoubles);
+    double fitted = (n % 2) ? slopes[n / 2] : (slopes[n / 2 - 1] + slopes[n / 2]) / 2;
+    int ok = fitted <= entry->exponent + ComplexityTolerance;
+    printf("%s,%.0f,%.2f,%s\n", entry->name, entry->exponent, fitted, ok ? "ok" : "FAIL");
+    fflush(stdout);
+    return ok;
+}
+
+
+/** @brief Mede um benchmark com um tamanho e escreve uma linha do resultado.
+ * 
+ * As iterações repetem-se até o tempo medido chegar ao pedido, ou até o tempo total
+ * (que inclui a preparação dos dados) chegar a 'BenchWallFactor' vezes o pedido.
+ * 
+ * @param entry Benchmark
+ * @param size Tamanho da entrada
+ * @param ip Interpretador usado pelos handlers
+ * @param time Tempo a medir (em nanosegundos)
+ */
+void bench_p_Measure(const BenchEntry* entry, int size, Interp* ip, long time)
+{
+    Bench b;
+    b.elapsed = 0;
+    b.allocs = 0;
+    b.bytes = 0;
+    b.ip = ip;
+    long ops = 0;
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long wall = 0;
+    while (b.elapsed < time && wall < time * BenchWallFactor)
+    {
+        ops += entry->run(&b, size);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        wall = (now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec);
+    }
+    printf("%s,%d,%ld,%.2f,%.3f,%.1f\n", entry->name, size, ops, (double)b.elapsed / ops,
+        (double)b.allocs / ops, (double)b.bytes / ops);
+    fflush(stdout);
+}
+
+/**
+ * Ponto de entrada dos benchmarks.
+ * 
+ * Opções aceites:
+ *   --filter S   Só corre os benchmarks com S no nome
+ *   --time MS    Tempo medido em cada benchmark e tamanho (por omissão 200, ou 50 com --complexity)
+ *   --complexity Em vez dos benchmarks, mede o expoente do crescimento de alguns operadores
+ * 
+ * O resultado é CSV: benchmark,size,ops,ns_per_op,allocs_per_op,bytes_per_op
+ * (ou operator,declared,fitted,status com --complexity, e termina com 1 se algum falhar).
+ */
+int main(int argc, char** argv)
+{
+    char* filter = NULL;
+    long time = 0;
+    int complexity = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+            time = atol(argv[++i]);
+        else if (strcmp(argv[i], "--complexity") == 0)
+            complexity = 1;
+        else fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+    }
+    FILE* sink = fopen("/dev/null", "w");
+    Interp* ip = interp_Create(stdin, sink);
+    if (time <= 0)
+        time = complexity ? ComplexityDefaultTime : BenchDefaultTime;
+    if (complexity)
+    {
+        int ok = 1;
+        printf("operator,declared,fitted,status\n");
+        for (size_t e = 0; e < sizeof(bench_p_complexity) / sizeof(ComplexityEntry); e++)
+            if (filter == NULL || strstr(bench_p_complexity[e].name, filter) != NULL)
+                ok &= bench_p_MeasureComplexity(&bench_p_complexity[e], ip, time * 1000000L);
+        interp_Dispose(ip);
+        fclose(sink);
+        return ok ? 0 : 1;
+    }
+    printf("benchmark,size,ops,ns_per_op,allocs_per_op,bytes_per_op\n");
+    for (size_t e = 0; e < sizeof(bench_p_entries) / sizeof(BenchEntry); e++)
+    {
+        if (filter != NULL && strstr(bench_p_entries[e].name, filter) == NULL)
+            continue;
+        for (int s = 0; s < BenchSizeCount; s++)
+            bench_p_Measure(&bench_p_entries[e], bench_p_sizes[s], ip, time * 1000000L);
+    }
+    interp_Dispose(ip);
+    fclose(sink);
+    return 0;
+}
+
+#endif
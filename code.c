@@ -0,0 +1,102 @@
+/**
+ * @file Código compilado: a linha (ou um bloco) convertida numa lista de instruções, para não ser lida outra vez
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "code.h"
+
+
+/** @brief Cria um código vazio.
+ * 
+ * @warning O novo código é criado com o "malloc", logo tem que ser libertado depois usando a função 'code_Dispose'.
+ * @returns Novo código
+ */
+Code* code_Create()
+{
+    Code* code = malloc(sizeof(Code));
+    code->array = malloc(CodeInitialSize * sizeof(Instruction));
+    code->capacity = CodeInitialSize;
+    code->count = 0;
+    code->blockStart = -1;
+    return code;
+}
+
+/** @brief Liberta a memória ocupada pelo código, pelas constantes e pelos códigos interiores.
+ * 
+ * @param code Apontador para o código
+ */
+void code_Dispose(Code* code)
+{
+    for (int i = 0; i < code->count; i++)
+    {
+        if (code->array[i].value != NULL)
+            item_Dispose(code->array[i].value);
+        if (code->array[i].sub != NULL)
+            code_Dispose(code->array[i].sub);
+    }
+    free(code->array);
+    free(code);
+}
+
+/** @brief Acrescenta uma instrução ao fim do código.
+ * 
+ * @param code Apontador para o código
+ * @param op Tipo da instrução
+ * @param cmd Char do comando
+ * @param value Constante (passa a pertencer ao código), ou NULL
+ * @param sub Código interior (passa a pertencer ao código), ou NULL
+ * @param pos Posição na linha do programa
+ */
+void code_Add(Code* code, OpCode op, char cmd, Item* value, Code* sub, int pos)
+{
+    if (code->count == code->capacity)
+    {
+        code->capacity *= 2;
+        code->array = realloc(code->array, code->capacity * sizeof(Instruction));
+    }
+    Instruction* ins = &code->array[code->count++];
+    ins->op = op;
+    ins->cmd = cmd;
+    ins->value = value;
+    ins->sub = sub;
+    ins->pos = pos;
+    ins->reserve = 0;
+    if (op == OP_Cmd || op == OP_ECmd)
+        code->blockStart = -1;
+    else
+    {
+        if (code->blockStart < 0)
+            code->blockStart = code->count - 1;
+        // O OP_Array também guarda um item, mas fá-lo com o 'stack_Push' (o código de dentro corre noutro stack)
+        if (op == OP_Push)
+            code->array[code->blockStart].reserve++;
+    }
+}
+
+/** @brief Verifica se o código pode ser executado em várias threads ao mesmo tempo.
+ * 
+ * Não pode se usar variáveis, ler a entrada ('l', 't'), imprimir ('p') ou sair de um ciclo ('b'),
+ * nem ele nem os arrays e blocos que tem lá dentro.
+ * 
+ * @param code Apontador para o código
+ * @returns 1 ou 0
+ */
+int code_IsParallelSafe(Code* code)
+{
+    for (int i = 0; i < code->count; i++)
+    {
+        Instruction* ins = &code->array[i];
+        if (ins->op == OP_SetVar)
+            return 0;
+        if (ins->op == OP_Cmd && ((ins->cmd >= 'A' && ins->cmd <= 'Z') || strchr("ltpb", ins->cmd) != NULL))
+            return 0;
+        if (ins->op == OP_Array && !code_IsParallelSafe(ins->sub))
+            return 0;
+        if (ins->op == OP_Push && ins->value->type == TBlock && !code_IsParallelSafe(((Block*)ins->value->pointer)->code))
+            return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file Código compilado: a linha (ou um bloco) convertida numa lista de instruções, para não ser lida outra vez
+ */
+
+#pragma once
+
+#include "item.h"
+
+/** Capacidade inicial da array de instruções */
+#define CodeInitialSize 16
+
+/**
+ * Enum que representa o tipo de uma instrução
+ */
+typedef enum OpCodeT
+{
+    OP_Push,    /*!< Guarda uma cópia da constante no stack (números, strings e blocos) */
+    OP_Array,   /*!< Executa o código interior num stack novo e guarda o resultado como lista */
+    OP_SetVar,  /*!< Guarda o topo do stack numa variável */
+    OP_Cmd,     /*!< Executa um comando */
+    OP_ECmd,    /*!< Executa um comando que começa por 'e' */
+} OpCode;
+
+/**
+ * Uma instrução do código compilado
+ */
+typedef struct InstructionT
+{
+    OpCode op;          /*!< Tipo da instrução */
+    char cmd;           /*!< Char do comando (no OP_ECmd, o char depois do 'e'; no OP_SetVar, a letra da variável) */
+    Item* value;        /*!< Constante a guardar no stack (apenas no OP_Push) */
+    struct CodeT* sub;  /*!< Código de dentro do array (apenas no OP_Array) */
+    int pos;            /*!< Posição na linha do programa onde começa a instrução (usada pelo profiler) */
+    int reserve;        /*!< Na primeira instrução de cada bloco básico, quantos items o bloco guarda no stack (0 nas outras) */
+} Instruction;
+
+/**
+ * Código compilado
+ */
+typedef struct CodeT
+{
+    Instruction* array; /*!< Array de instruções */
+    int count;          /*!< Quantidade de instruções */
+    int capacity;       /*!< Capacidade da array */
+    int blockStart;     /*!< Indice da primeira instrução do bloco básico que está a ser acrescentado (-1 depois de um comando) */
+} Code;
+
+
+/** @brief Cria um código vazio.
+ * 
+ * @warning O novo código é criado com o "malloc", logo tem que ser libertado depois usando a função 'code_Dispose'.
+ * @returns Novo código
+ */
+Code* code_Create();
+
+/** @brief Liberta a memória ocupada pelo código, pelas constantes e pelos códigos interiores.
+ * 
+ * @param code Apontador para o código
+ */
+void code_Dispose(Code* code);
+
+/** @brief Acrescenta uma instrução ao fim do código.
+ * 
+ * Um bloco básico é uma sequência de instruções sem comandos: o efeito delas no stack é conhecido antes de
+ * correr (cada OP_Push guarda um item), por isso a VM verifica a capacidade do stack só no inicio do bloco.
+ * Os comandos acabam o bloco, porque o que fazem ao stack depende dos tipos dos items.
+ * 
+ * @param code Apontador para o código
+ * @param op Tipo da instrução
+ * @param cmd Char do comando
+ * @param value Constante (passa a pertencer ao código), ou NULL
+ * @param sub Código interior (passa a pertencer ao código), ou NULL
+ * @param pos Posição na linha do programa
+ */
+void code_Add(Code* code, OpCode op, char cmd, Item* value, Code* sub, int pos);
+
+/** @brief Verifica se o código pode ser executado em várias threads ao mesmo tempo.
+ * 
+ * Não pode se usar variáveis, ler a entrada ('l', 't'), imprimir ('p') ou sair de um ciclo ('b'),
+ * nem ele nem os arrays e blocos que tem lá dentro.
+ * 
+ * @param code Apontador para o código
+ * @returns 1 ou 0
+ */
+int code_IsParallelSafe(Code* code);
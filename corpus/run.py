@@ -0,0 +1,155 @@
+#!/usr/bin/python3
+
+"""
+Corre os programas do corpus, verifica o resultado e compara o desempenho com a baseline.
+
+Cada programa é um par de ficheiros nesta pasta:
+- NOME.in  : a entrada completa (a primeira linha é o programa, o resto é lido pelo 'l' e pelo 't')
+- NOME.out : o resultado esperado
+
+Para cada programa são medidos o tempo (o melhor de --repeat execuções), o pico de memória
+(RSS máximo) e as alocações. As alocações só são medidas se o executável tiver sido compilado
+com a contagem (ver o compile.txt); sem ela ficam de fora da comparação.
+
+Uso:
+    corpus/run.py [--bin ./t] [--repeat 5] [--threshold 10] [--timing] [--update]
+
+Por omissão só o resultado e as alocações (que não dependem da máquina) são comparados, com a
+baseline em corpus/baseline.json, que está no git. O tempo e o RSS só são comparados com --timing,
+com a baseline em corpus/timing.local.json, que não está no git: tem que ser gerada com --update
+na máquina onde se vai comparar.
+
+Com --update os valores medidos passam a ser as duas baselines.
+A script termina com 1 se algum resultado estiver errado ou se algum valor comparado piorar mais
+do que --threshold por cento em relação à baseline.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+parser = argparse.ArgumentParser(description = "Corre o corpus de programas e compara com a baseline")
+parser.add_argument("--bin", default = "./t", help = "executável a testar")
+parser.add_argument("--repeat", type = int, default = 5, help = "execuções por programa (conta a melhor)")
+parser.add_argument("--threshold", type = float, default = 10.0, help = "percentagem de piora aceite")
+parser.add_argument("--baseline", default = os.path.join(here, "baseline.json"), help = "baseline das alocações")
+parser.add_argument("--timing-baseline", default = os.path.join(here, "timing.local.json"),
+                    help = "baseline do tempo e do RSS (desta máquina)")
+parser.add_argument("--timing", action = "store_true", help = "compara também o tempo e o RSS")
+parser.add_argument("--update", action = "store_true", help = "guarda os valores medidos como baselines")
+args = parser.parse_args()
+
+# Valores guardados em cada baseline
+deterministic_keys = ("allocs",)
+timing_keys = ("time", "rss")
+
+# Abaixo disto as diferenças de tempo são ruído
+min_time_delta = 0.005
+
+
+def run(path):
+    """Corre um programa uma vez e devolve (saída, segundos, RSS máximo em KiB, alocações ou None)."""
+    with open(path, "rb") as stdin, tempfile.TemporaryFile() as out, tempfile.TemporaryFile() as err:
+        start = time.perf_counter()
+        process = subprocess.Popen([args.bin, "--stats"], stdin = stdin, stdout = out, stderr = err)
+        # O 'wait4' (em vez do 'wait') dá também os recursos usados só por este processo
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        process.returncode = os.waitstatus_to_exitcode(status)
+        out.seek(0)
+        err.seek(0)
+        allocs = re.search(rb"allocs=(\d+)", err.read())
+        return out.read(), elapsed, usage.ru_maxrss, int(allocs.group(1)) if allocs else None
+
+
+def measure(path):
+    """Corre um programa --repeat vezes e guarda o melhor tempo, o maior RSS e as alocações."""
+    values = {"time": None, "rss": 0, "allocs": None}
+    output = None
+    for _ in range(args.repeat):
+        out, elapsed, rss, allocs = run(path)
+        output = out if output is None else output
+        values["time"] = elapsed if values["time"] is None else min(values["time"], elapsed)
+        values["rss"] = max(values["rss"], rss)
+        values["allocs"] = allocs
+    return output, values
+
+
+def compare(key, value, base):
+    """Verifica se um valor piorou mais do que o threshold. Devolve a descrição e se é uma regressão."""
+    if value is None or base is None or key not in base or base[key] is None:
+        return "%s=%s" % (key, fmt(key, value)), False
+    old = base[key]
+    change = (value - old) / old * 100 if old else 0.0
+    regression = change > args.threshold and not (key == "time" and value - old < min_time_delta)
+    return "%s=%s (%+.1f%%)" % (key, fmt(key, value), change), regression
+
+
+def fmt(key, value):
+    """Formata um valor medido."""
+    if value is None:
+        return "-"
+    if key == "time":
+        return "%.3fs" % value
+    if key == "rss":
+        return "%dKiB" % value
+    return str(value)
+
+
+def load(path):
+    """Lê uma baseline (vazia se não existir ou com --update)."""
+    if args.update or not os.path.exists(path):
+        return {}
+    with open(path) as f:
+        return json.load(f)
+
+
+def save(path, results, keys):
+    """Guarda os valores medidos de algumas chaves como baseline."""
+    with open(path, "w") as f:
+        json.dump({name: {key: values[key] for key in keys} for name, values in results.items()},
+                  f, indent = 4, sort_keys = True)
+        f.write("\n")
+    print("Baseline guardada em", path)
+
+
+baseline = load(args.baseline)
+timing_baseline = load(args.timing_baseline)
+
+results = {}
+failed = False
+for file in sorted(os.listdir(here)):
+    if not file.endswith(".in"):
+        continue
+    name = file[:-3]
+    with open(os.path.join(here, name + ".out"), "rb") as f:
+        expected = f.read()
+    out, values = measure(os.path.join(here, file))
+    results[name] = values
+    line = [name.ljust(16)]
+    if out != expected:
+        line.append("WRONG OUTPUT")
+        failed = True
+    else:
+        line.append("ok")
+    for key in timing_keys + deterministic_keys:
+        base = timing_baseline.get(name) if key in timing_keys else baseline.get(name)
+        if key in timing_keys and not args.timing:
+            base = None
+        text, regression = compare(key, values[key], base)
+        line.append(text + (" REGRESSION" if regression else ""))
+        failed = failed or regression
+    print("  ".join(line))
+
+if args.update:
+    save(args.baseline, results, deterministic_keys)
+    save(args.timing_baseline, results, timing_keys)
+
+sys.exit(1 if failed else 0)
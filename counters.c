@@ -0,0 +1,151 @@
+/**
+ * @file Contadores do processador (ciclos, instruções, cache misses e branch misses) lidos com o perf_event_open do Linux
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
+#include "counters.h"
+#include "pool.h"
+
+/** Quantidade máxima de descritores abertos (todos os contadores de cada thread da pool e da principal) */
+#define CountersMaxFds ((PoolMaxThreads + 1) * CT_Count)
+
+/** Nome de cada contador */
+static const char* counters_p_names[CT_Count] =
+{
+    "cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+/** Evento do perf_event_open de cada contador */
+static const uint64_t counters_p_configs[CT_Count] =
+{
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Estado global: ligado, contadores disponíveis na thread que ligou, e os descritores de todas as threads (para fechar)
+static int counters_p_enabled, counters_p_available[CT_Count], counters_p_generation;
+static int counters_p_fds[CountersMaxFds], counters_p_fdCount;
+static pthread_mutex_t counters_p_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Estado de cada thread: o líder do grupo (-1 se nenhum abriu), a posição de cada contador na leitura (-1 se
+// indisponível) e a geração em que foram abertos (são reabertos se os contadores forem desligados e ligados)
+static __thread int counters_p_leader = -1, counters_p_index[CT_Count], counters_p_count, counters_p_opened;
+
+
+/** @brief Abre os contadores da thread atual num só grupo, saltando os que o sistema não deixar abrir.
+ * 
+ * @returns O errno do primeiro que falhou (0 se abriram todos)
+ */
+int counters_p_Open()
+{
+    int error = 0;
+    counters_p_leader = -1;
+    counters_p_count = 0;
+    counters_p_opened = counters_p_generation;
+    for (int c = 0; c < CT_Count; c++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = counters_p_configs[c];
+        attr.read_format = PERF_FORMAT_GROUP;
+        // Só o código do programa: é o que o perf_event_paranoid costuma deixar contar
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, counters_p_leader, 0);
+        if (fd < 0)
+        {
+            error = error ? error : errno;
+            counters_p_index[c] = -1;
+            continue;
+        }
+        pthread_mutex_lock(&counters_p_lock);
+        if (counters_p_fdCount < CountersMaxFds)
+            counters_p_fds[counters_p_fdCount++] = fd;
+        pthread_mutex_unlock(&counters_p_lock);
+        if (counters_p_leader < 0)
+            counters_p_leader = fd;
+        counters_p_index[c] = counters_p_count++;
+    }
+    return error;
+}
+
+/** @brief Liga os contadores e abre-os na thread atual. Se nenhum estiver disponível escreve um aviso na 'stderr'.
+ * 
+ * @returns Quantidade de contadores disponíveis (0 se o sistema não os deixar abrir)
+ */
+int counters_Enable()
+{
+    counters_p_generation++;
+    int error = counters_p_Open();
+    for (int c = 0; c < CT_Count; c++)
+        counters_p_available[c] = counters_p_index[c] >= 0;
+    if (counters_p_count == 0)
+        fprintf(stderr, "Hardware counters are not available (%s), profiling without them\n", strerror(error));
+    counters_p_enabled = counters_p_count > 0;
+    return counters_p_count;
+}
+
+/** @brief Desliga os contadores e fecha os de todas as threads.
+ */
+void counters_Disable()
+{
+    pthread_mutex_lock(&counters_p_lock);
+    for (int i = 0; i < counters_p_fdCount; i++)
+        close(counters_p_fds[i]);
+    counters_p_fdCount = 0;
+    pthread_mutex_unlock(&counters_p_lock);
+    counters_p_enabled = 0;
+    counters_p_generation++;
+}
+
+/** @brief Verifica se os contadores estão ligados e há pelo menos um disponível.
+ * 
+ * @returns 1 ou 0
+ */
+int counters_Enabled()
+{ return counters_p_enabled; }
+
+/** @brief Verifica se um contador está disponível (na thread que ligou os contadores).
+ * 
+ * @param counter Contador
+ * @returns 1 ou 0
+ */
+int counters_Available(Counter counter)
+{ return counters_p_enabled && counters_p_available[counter]; }
+
+/** @brief Dá o nome de um contador.
+ * 
+ * @param counter Contador
+ * @returns Nome (não pode ser alterado)
+ */
+const char* counters_Name(Counter counter)
+{ return counters_p_names[counter]; }
+
+/** @brief Lê os contadores da thread atual (abrindo-os se é a primeira vez), numa só chamada ao sistema.
+ * 
+ * @param values Out: valor de cada contador desde que foi aberto (0 nos indisponíveis)
+ */
+void counters_Read(long values[CT_Count])
+{
+    // O grupo é lido de uma vez: a quantidade de contadores seguida do valor de cada um
+    uint64_t buffer[1 + CT_Count];
+    if (counters_p_opened != counters_p_generation)
+        counters_p_Open();
+    ssize_t expected = (ssize_t)((1 + counters_p_count) * sizeof(uint64_t));
+    if (counters_p_leader < 0 || read(counters_p_leader, buffer, sizeof(buffer)) < expected)
+    {
+        memset(values, 0, CT_Count * sizeof(long));
+        return;
+    }
+    for (int c = 0; c < CT_Count; c++)
+        values[c] = (counters_p_index[c] >= 0) ? (long)buffer[1 + counters_p_index[c]] : 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file Contadores do processador (ciclos, instruções, cache misses e branch misses) lidos com o perf_event_open do Linux
+ * 
+ * Cada thread abre os seus contadores da primeira vez que os lê. Os que o sistema não deixar abrir (sem permissões,
+ * dentro de um container, numa máquina virtual, ...) ficam indisponíveis e são lidos sempre como 0.
+ */
+
+#pragma once
+
+/**
+ * Contadores lidos
+ */
+typedef enum CounterT
+{
+    CT_Cycles,          /*!< Ciclos do processador */
+    CT_Instructions,    /*!< Instruções do processador executadas */
+    CT_CacheMisses,     /*!< Acessos à memória que falharam a ultima cache */
+    CT_BranchMisses,    /*!< Saltos condicionais mal previstos */
+    CT_Count,           /*!< Quantidade de contadores */
+} Counter;
+
+
+/** @brief Liga os contadores e abre-os na thread atual. Se nenhum estiver disponível escreve um aviso na 'stderr'.
+ * 
+ * @returns Quantidade de contadores disponíveis (0 se o sistema não os deixar abrir)
+ */
+int counters_Enable();
+
+/** @brief Desliga os contadores e fecha os de todas as threads.
+ */
+void counters_Disable();
+
+/** @brief Verifica se os contadores estão ligados e há pelo menos um disponível.
+ * 
+ * @returns 1 ou 0
+ */
+int counters_Enabled();
+
+/** @brief Verifica se um contador está disponível (na thread que ligou os contadores).
+ * 
+ * @param counter Contador
+ * @returns 1 ou 0
+ */
+int counters_Available(Counter counter);
+
+/** @brief Dá o nome de um contador.
+ * 
+ * @param counter Contador
+ * @returns Nome (não pode ser alterado)
+ */
+const char* counters_Name(Counter counter);
+
+/** @brief Lê os contadores da thread atual (abrindo-os se é a primeira vez), numa só chamada ao sistema.
+ * 
+ * @param values Out: valor de cada contador desde que foi aberto (0 nos indisponíveis)
+ */
+void counters_Read(long values[CT_Count]);
@@ -2,45 +2,27 @@
  * @file Handlers - Funções que processam alguns comandos, neste caso, sobre funções de arrays
  */
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "handler_array.h"
 #include "itemfunctions.h"
-#include "parser.h"
+#include "itemset.h"
+#include "sort.h"
 #include "utils.h"
 
-// ""
-/** @brief Função que gera uma string, da entrada.
- * 
- * @param stack Apontador para o stack
- * @param cmd Char do comando
- * @param line Linha de entrada
- * @param linePos Posição de leitura na linha
- * @returns 1 se tiver sucesso
- */
-int h_a_CreateString(Stack* stack, char cmd, char* line, int* linePos)
-{
-    if (cmd != '\"')
-        return 0;
-    int end = utils_NextChar(line, *linePos, '\"');
-    char* string = utils_Substring(line + *linePos, end - *linePos);
-    Item* item = icreate_String(string, end - *linePos);
-    stack_Push(stack, item);
-    *linePos = end + 1;
-    return 1;
-}
-
 // ~
 /** @brief Função que gera uma string, da entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_Split(Stack* stack, char cmd)
+int h_a_Split(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '~')
         return 0;
     Item* item = stack_Peek(stack);
@@ -77,10 +59,14 @@ int h_ah_ConcatStrings(Item* ia, Item* ib, long* result)
 {
     if (!(ia->type == ib->type && ia->type == TString))
         return 0;
-    char* a = (char*)ia->pointer, *b = (char*)ib->pointer;
-    char* s = utils_ConcatString(a, b);
-    *result = (long)icreate_String(s, strlen(s));
-    item_Dispose(ia); item_Dispose(ib);
+    // A string A é só deste item, por isso B é acrescentada no mesmo buffer; quando não cabe,
+    // o buffer duplica, para que juntar N strings pequenas custe O(N) no total
+    item_ReserveString(ia, ia->size + ib->size);
+    memcpy((char*)ia->pointer + ia->size, ib->pointer, ib->size + 1);
+    ia->size += ib->size;
+    item_InvalidateHash(ia);
+    *result = (long)ia;
+    item_Dispose(ib);
     return 1;
 }
 /** @brief Função que junta string e char.
@@ -98,6 +84,7 @@ int h_ah_ConcatStringChar(Item* ia, Item* ib, long* result)
     char* b = calloc(2, sizeof(char));
     b[0] =  *(char*)ib->pointer;
     char* s = utils_ConcatString(a, b);
+    free(b);
     *result = (long)icreate_String(s, strlen(s));
     item_Dispose(ia); item_Dispose(ib);
     return 1;
@@ -158,12 +145,13 @@ int h_ah_ConcatItemList(Item* ia, Item* ib, long* result)
 
 /** @brief Função que junta strings, arrays e elementos.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_Concat(Stack* stack, char cmd)
+int h_a_Concat(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '+')
         return 0;
     Item* ib = stack_Pop(stack);
@@ -192,55 +180,68 @@ int h_a_Concat(Stack* stack, char cmd)
 // *
 /** @brief Função que repete strings ou arrays X vezes.
  * 
- * @param stack Apontador para o stack
+ * O resultado é uma vista (a repetição só é feita quando for preciso),
+ * e repetir uma vista apenas multiplica a quantidade de repetições.
+ * 
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_ConcatX(Stack* stack, char cmd)
+int h_a_ConcatX(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '*')
         return 0;
-    Item* in = stack_Pop(stack);
-    Item* ia = stack_Pop(stack);
-    if (!item_IsType(ia, IT_Arr) || !item_IsType(in, IT_Num))
+    Item* in = stack_PopLazy(stack);
+    Item* ia = stack_PopLazy(stack);
+    if (!(item_IsType(ia, IT_Arr) || ia->type == TRepeat) || !item_IsType(in, IT_Num))
     {
         stack_Push(stack, ia);
         stack_Push(stack, in);
         return 0;
     }
     long n = i_ToLong(in);
-    Item* result;
-    if (ia->type == TString)
+    if (n < 0) n = 0;
+    Item* source = (ia->type == TRepeat) ? ((Repeat*)ia->pointer)->source : ia;
+    long length = item_Length(source), count = (ia->type == TRepeat) ? ((Repeat*)ia->pointer)->count : 1;
+    if (length == 0 || n == 0 || count == 0)
     {
-        char* s = utils_RepeatString((char*)ia->pointer, ia->size, n);
-        result = icreate_String(s, ia->size * n);
+        // Uma vista vazia ainda teria que dar as voltas todas quando fosse materializada ou impressa
+        int isString = source->type == TString;
+        item_Dispose(ia); item_Dispose(in);
+        stack_Push(stack, isString ? icreate_String(calloc(1, 1), 0) : icreate_FromList(list_Create(0)));
+        return 1;
     }
-    else
+    // O resultado tem que caber numa string ou lista (count * n * length <= INT_MAX, sem overflow)
+    if (count > INT_MAX / length / n)
     {
-        List* l = (List*)ia->pointer;
-        List* newl = list_Create(l->count * n);
-        for (int i = 0; i < n; i++)
-            list_AddCopyRange(newl, l);
-        result = icreate_FromList(newl);
+        stack_Push(stack, ia);
+        stack_Push(stack, in);
+        return 0;
     }
-    item_Dispose(ia);
     item_Dispose(in);
-    stack_Push(stack, result);
+    if (ia->type == TRepeat)
+    {
+        ((Repeat*)ia->pointer)->count = count * n;
+        stack_Push(stack, ia);
+    }
+    else stack_Push(stack, icreate_Repeat(ia, n));
     return 1;
 }
 
 // ,
 /** @brief Função que dá o tamanho de uma string ou lista, ou cria uma lista com X elementos.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_RangeSize(Stack* stack, char cmd)
+int h_a_RangeSize(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != ',')
         return 0;
-    Item* ia = stack_Pop(stack);
+    Item* ia = stack_PopLazy(stack);
     if (item_IsType(ia, IT_Num))
     {
         List* l = list_CreateRange(i_ToLong(ia));
@@ -254,10 +255,9 @@ int h_a_RangeSize(Stack* stack, char cmd)
         item_Dispose(ia);
         return 1;
     }
-    else if (ia->type == TList)
+    else if (ia->type == TList || ia->type == TRepeat)
     {
-        List* l = (List*)ia->pointer;
-        stack_Push(stack, icreate_Long(l->count));
+        stack_Push(stack, icreate_Long(item_Length(ia)));
         item_Dispose(ia);
         return 1;
     }
@@ -268,24 +268,31 @@ int h_a_RangeSize(Stack* stack, char cmd)
 // =
 /** @brief Função que retira um elemento duma lista.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_ByIndex(Stack* stack, char cmd)
+int h_a_ByIndex(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '=')
         return 0;
-    Item* in = stack_Pop(stack);
-    Item* ia = stack_Pop(stack);
-    if (!item_IsType(in, IT_Num) || !item_IsType(ia, IT_Arr))
+    Item* in = stack_PopLazy(stack);
+    Item* ia = stack_PopLazy(stack);
+    if (!item_IsType(in, IT_Num) || !(item_IsType(ia, IT_Arr) || ia->type == TRepeat))
     {
         stack_Push(stack, ia);
         stack_Push(stack, in);
         return 0;
     }
     int n = i_ToLong(in);
-    if (ia->type == TList)
+    if (ia->type == TRepeat)
+    {
+        if (n >= 0 && n < item_Length(ia))
+            stack_Push(stack, item_At(ia, n));
+        else stack_Push(stack, icreate_Long(0));
+    }
+    else if (ia->type == TList)
     {
         List* l = (List*)ia->pointer;
         Item* i = list_RemoveAt(l, n);
@@ -305,12 +312,13 @@ int h_a_ByIndex(Stack* stack, char cmd)
 // #
 /** @brief Função que procura uma string num string maior.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_FindSub(Stack* stack, char cmd)
+int h_a_FindSub(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '#')
         return 0;
     Item* is = stack_Pop(stack);
@@ -331,60 +339,16 @@ int h_a_FindSub(Stack* stack, char cmd)
 }
 
 
-// []
-/** @brief Função que procura o final do array.
- * 
- * @param line Linha da entrada
- * @param linePos Posição na linha
- * @returns Posição do final
- */
-int h_ah_FindEndOfArray(char* line, int* linePos)
-{
-    int score = 1;
-    int size = strlen(line);
-    int pos = *linePos;
-    while (score > 0 && pos < size)
-    {
-        if (line[pos] == '[')
-            score++;
-        else if (line[pos] == ']')
-            score--;
-        pos++;
-    }
-    return pos - 1;
-}
-
-/** @brief Função que procura uma string num string maior.
- * 
- * @param stack Apontador para o stack
- * @param cmd Char do comando
- * @returns 1 se tiver sucesso
- */
-int h_a_Array(Item** vars, Stack* stack, char cmd, char* line, int* linePos)
-{
-    if (cmd != '[')
-        return 0;
-    int end = h_ah_FindEndOfArray(line, linePos);
-    char* arrayString = utils_Substring(line + *linePos, end - *linePos);
-    Stack* newStack = stack_Create(StackInitialSize);
-    parser_Process(vars, newStack, arrayString, end - *linePos);
-    Item* result = icreate_FromList(stack_ToList(newStack));
-    stack_Push(stack, result);
-    stack_Dispose(newStack);
-    *linePos = end + 1;
-    return 1;
-}
-
-
 // (
 /** @brief Função que retira o primeiro elemento de uma string ou array.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_First(Stack* stack, char cmd)
+int h_a_First(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '(')
         return 0;
     Item* ia = stack_Peek(stack);
@@ -392,11 +356,11 @@ int h_a_First(Stack* stack, char cmd)
         return 0;
     if (ia->type == TString)
     {
-        stack_Push(stack, icreate_Char(((char*)ia->pointer)[0]));
-        char* s = utils_Substring((char*)ia->pointer + 1, ia->size - 1);
-        free(ia->pointer);
-        ia->pointer = s;
+        char* s = (char*)ia->pointer;
+        stack_Push(stack, icreate_Char(s[0]));
+        memmove(s, s + 1, ia->size);
         ia->size -= 1;
+        item_InvalidateHash(ia);
     }
     else
     {
@@ -409,12 +373,13 @@ int h_a_First(Stack* stack, char cmd)
 // )
 /** @brief Função que retira o ultimo elemento de uma string ou array.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_Last(Stack* stack, char cmd)
+int h_a_Last(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != ')')
         return 0;
     Item* ia = stack_Peek(stack);
@@ -422,11 +387,11 @@ int h_a_Last(Stack* stack, char cmd)
         return 0;
     if (ia->type == TString)
     {
-        stack_Push(stack, icreate_Char(((char*)ia->pointer)[ia->size - 1]));
-        char* s = utils_Substring((char*)ia->pointer, ia->size - 1);
-        free(ia->pointer);
-        ia->pointer = s;
-        ia->size -= 1;
+        // Basta encurtar a string no mesmo buffer
+        char* s = (char*)ia->pointer;
+        stack_Push(stack, icreate_Char(s[ia->size - 1]));
+        s[--ia->size] = '\0';
+        item_InvalidateHash(ia);
     }
     else
     {
@@ -439,38 +404,28 @@ int h_a_Last(Stack* stack, char cmd)
 // <
 /** @brief Função que retira X elemento do inicio de uma string ou array.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_FirstX(Stack* stack, char cmd)
+int h_a_FirstX(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '<')
         return 0;
-    Item* in = stack_Pop(stack);
-    Item* ia = stack_Pop(stack);
-    if (!item_IsType(ia, IT_Arr) || !item_IsType(in, IT_Num))
+    Item* in = stack_PopLazy(stack);
+    Item* ia = stack_PopLazy(stack);
+    if (!(item_IsType(ia, IT_Arr) || ia->type == TRepeat) || !item_IsType(in, IT_Num))
     {
         stack_Push(stack, ia);
         stack_Push(stack, in);
         return 0;
     }
-    int n = i_ToLong(in);
-    if (ia->type == TString)
-    {
-        if (n > ia->size) n = ia->size;
-        char* s = utils_Substring(ia->pointer, n);
-        stack_Push(stack, icreate_String(s, n));
-    }
-    else
-    {
-        List* list = ia->pointer;
-        if (n > list->count) n = list->count;
-        List* newL = list_Create(n);
-        for (int i = 0; i < n; i++)
-            list_Add(newL, item_Copy(list->array[i]));
-        stack_Push(stack, icreate_FromList(newL));
-    }
+    long n = i_ToLong(in);
+    long length = item_Length(ia);
+    if (n > length) n = length;
+    if (n < 0) n = 0;
+    stack_Push(stack, item_Slice(ia, 0, n));
     item_Dispose(ia);
     item_Dispose(in);   
     return 1;
@@ -478,38 +433,28 @@ int h_a_FirstX(Stack* stack, char cmd)
 
 /** @brief Função que retira X elemento do fim de uma string ou array.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_LastX(Stack* stack, char cmd)
+int h_a_LastX(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '>')
         return 0;
-    Item* in = stack_Pop(stack);
-    Item* ia = stack_Pop(stack);
-    if (!item_IsType(ia, IT_Arr) || !item_IsType(in, IT_Num))
+    Item* in = stack_PopLazy(stack);
+    Item* ia = stack_PopLazy(stack);
+    if (!(item_IsType(ia, IT_Arr) || ia->type == TRepeat) || !item_IsType(in, IT_Num))
     {
         stack_Push(stack, ia);
         stack_Push(stack, in);
         return 0;
     }
-    int n = i_ToLong(in);
-    if (ia->type == TString)
-    {
-        if (n > ia->size) n = ia->size;
-        char* s = utils_Substring((char*)ia->pointer + ia->size - n, n);
-        stack_Push(stack, icreate_String(s, n));
-    }
-    else
-    {
-        List* list = ia->pointer;
-        if (n > list->count) n = list->count;
-        List* newL = list_Create(n);
-        for (int i = list->count - n; i < list->count; i++)
-            list_Add(newL, item_Copy(list->array[i]));
-        stack_Push(stack, icreate_FromList(newL));
-    }
+    long n = i_ToLong(in);
+    long length = item_Length(ia);
+    if (n > length) n = length;
+    if (n < 0) n = 0;
+    stack_Push(stack, item_Slice(ia, length - n, n));
     item_Dispose(ia);
     item_Dispose(in);   
     return 1;
@@ -519,12 +464,13 @@ int h_a_LastX(Stack* stack, char cmd)
 // /
 /** @brief Função que divide uma string usando outra como separador.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_a_SplitString(Stack* stack, char cmd)
+int h_a_SplitString(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '/')
         return 0;
     Item* is = stack_Pop(stack);
@@ -553,6 +499,7 @@ int h_a_SplitString(Stack* stack, char cmd)
         list_Add(parts, i);
         token = strtok(NULL, sub);
     }
+    free(testStr);
     if (is->type == TChar)
         free(sub);
     stack_Push(stack, icreate_FromList(parts));
@@ -562,20 +509,252 @@ int h_a_SplitString(Stack* stack, char cmd)
 
 
 
+// $
+/** @brief Função que ordena uma lista ou os chars de uma string.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_a_Sort(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    if (cmd != '$')
+        return 0;
+    Item* ia = stack_Peek(stack);
+    if (ia == NULL || !item_IsType(ia, IT_Arr))
+        return 0;
+    if (ia->type == TString)
+        sort_Chars((char*)ia->pointer, ia->size);
+    else
+    {
+        List* l = (List*)ia->pointer;
+        sort_Items(l->array, l->count);
+    }
+    item_InvalidateHash(ia);
+    return 1;
+}
+
+
+
+// | & -
+/** @brief Função que faz uma operação de conjuntos com os chars de duas strings.
+ * 
+ * @param ia String A
+ * @param ib String B
+ * @param cmd '|' (união), '&' (interseção) ou '-' (diferença)
+ * @returns Nova string
+ */
+Item* h_ah_StringSet(Item* ia, Item* ib, char cmd)
+{
+    char* a = (char*)ia->pointer, *b = (char*)ib->pointer;
+    char inB[256] = { 0 }, seen[256] = { 0 };
+    for (int i = 0; i < ib->size; i++)
+        inB[(unsigned char)b[i]] = 1;
+    char* s = calloc(ia->size + ib->size + 1, sizeof(char));
+    int size = 0;
+    for (int i = 0; i < ia->size; i++)
+    {
+        unsigned char c = a[i];
+        if (cmd == '-' ? !inB[c] : (!seen[c] && (cmd == '|' || inB[c])))
+            s[size++] = c;
+        seen[c] = 1;
+    }
+    for (int i = 0; cmd == '|' && i < ib->size; i++)
+        if (!seen[(unsigned char)b[i]])
+        {
+            s[size++] = b[i];
+            seen[(unsigned char)b[i]] = 1;
+        }
+    s[size] = '\0';
+    return icreate_String(s, size);
+}
+
+/** @brief Função que faz uma operação de conjuntos com duas listas.
+ * 
+ * Os items de A que ficam no resultado são movidos (não copiados) e a lista A fica vazia.
+ * 
+ * @param ia Lista A
+ * @param ib Lista B
+ * @param cmd '|' (união), '&' (interseção) ou '-' (diferença)
+ * @returns Nova lista
+ */
+Item* h_ah_ListSet(Item* ia, Item* ib, char cmd)
+{
+    List* a = (List*)ia->pointer, *b = (List*)ib->pointer;
+    List* result = list_Create(a->count + b->count);
+    int numeric = set_IsMixed(a, b);
+    ItemSet* seen = set_Create(a->count + b->count, numeric);
+    ItemSet* inB = NULL;
+    if (cmd != '|')
+    {
+        inB = set_Create(b->count, numeric);
+        set_AddList(inB, b);
+    }
+    for (int i = 0; i < a->count; i++)
+    {
+        Item* item = a->array[i];
+        int keep = (cmd == '-') ? !set_Contains(inB, item) :
+            ((cmd == '|' || set_Contains(inB, item)) && set_Add(seen, item));
+        if (keep)
+            list_Add(result, item);
+        else item_Dispose(item);
+    }
+    a->count = 0;
+    for (int i = 0; cmd == '|' && i < b->count; i++)
+        if (set_Add(seen, b->array[i]))
+        {
+            list_Add(result, b->array[i]);
+            b->array[i] = NULL;
+        }
+    set_Dispose(seen);
+    if (inB != NULL)
+        set_Dispose(inB);
+    return icreate_FromList(result);
+}
+
+/** @brief Função que faz uma operação de conjuntos com duas listas ou strings.
+ * 
+ * Se uma for string e a outra lista, a string passa a ser uma lista de chars.
+ * A união e a interseção não têm repetidos, a diferença mantém os repetidos de A.
+ * Em todas fica a ordem em que os items aparecem pela primeira vez.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd '|' (união), '&' (interseção) ou '-' (diferença)
+ * @returns 1 se tiver sucesso
+ */
+int h_ah_SetOperation(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* ib = stack_Pop(stack);
+    Item* ia = stack_Pop(stack);
+    if (!item_IsType(ia, IT_Arr) || !item_IsType(ib, IT_Arr))
+    {
+        stack_Push(stack, ia);
+        stack_Push(stack, ib);
+        return 0;
+    }
+    if (ia->type != ib->type)
+    {
+        ifunc_ConvertToList(ia);
+        ifunc_ConvertToList(ib);
+    }
+    Item* result;
+    if (ia->type == TString)
+        result = h_ah_StringSet(ia, ib, cmd);
+    else
+    {
+        result = h_ah_ListSet(ia, ib, cmd);
+        // Os items de B que foram movidos ficaram a NULL
+        List* b = (List*)ib->pointer;
+        for (int i = 0; i < b->count; i++)
+            if (b->array[i] != NULL)
+                item_Dispose(b->array[i]);
+        b->count = 0;
+    }
+    item_Dispose(ia); item_Dispose(ib);
+    stack_Push(stack, result);
+    return 1;
+}
+
+/** @brief Função que faz a união de duas listas ou strings.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_a_Union(Interp* ip, char cmd)
+{
+    if (cmd != '|')
+        return 0;
+    return h_ah_SetOperation(ip, cmd);
+}
+
+/** @brief Função que faz a interseção de duas listas ou strings.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_a_Intersection(Interp* ip, char cmd)
+{
+    if (cmd != '&')
+        return 0;
+    return h_ah_SetOperation(ip, cmd);
+}
+
+/** @brief Função que tira de uma lista ou string os items que estão noutra.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_a_Difference(Interp* ip, char cmd)
+{
+    if (cmd != '-')
+        return 0;
+    return h_ah_SetOperation(ip, cmd);
+}
+
+// n
+/** @brief Função que remove os items repetidos de uma lista ou string (fica a primeira vez que aparecem).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_a_Unique(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    if (cmd != 'n')
+        return 0;
+    Item* ia = stack_Peek(stack);
+    if (ia == NULL || !item_IsType(ia, IT_Arr))
+        return 0;
+    int size = 0;
+    if (ia->type == TString)
+    {
+        char* s = (char*)ia->pointer, seen[256] = { 0 };
+        for (int i = 0; i < ia->size; i++)
+            if (!seen[(unsigned char)s[i]])
+            {
+                seen[(unsigned char)s[i]] = 1;
+                s[size++] = s[i];
+            }
+        s[size] = '\0';
+        ia->size = size;
+    }
+    else
+    {
+        List* l = (List*)ia->pointer;
+        ItemSet* seen = set_Create(l->count, set_IsMixed(l, NULL));
+        for (int i = 0; i < l->count; i++)
+            if (set_Add(seen, l->array[i]))
+                l->array[size++] = l->array[i];
+            else item_Dispose(l->array[i]);
+        for (int i = size; i < l->count; i++)
+            l->array[i] = NULL;
+        l->count = size;
+        set_Dispose(seen);
+    }
+    item_InvalidateHash(ia);
+    return 1;
+}
+
+
+
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Array(Item** vars, Stack* stack, char cmd, char* line, int* linePos)
+int hHub_Array(Interp* ip, char cmd)
 {
-    return h_a_CreateString(stack, cmd, line, linePos) || h_a_Array(vars, stack, cmd, line, linePos) || 
-    h_a_Split(stack, cmd) || h_a_Concat(stack, cmd) || h_a_ConcatX(stack, cmd) || 
-    h_a_RangeSize(stack, cmd) || h_a_ByIndex(stack, cmd) || h_a_FindSub(stack, cmd) ||
-    h_a_First(stack, cmd) || h_a_Last(stack, cmd) || h_a_FirstX(stack, cmd) ||
-    h_a_LastX(stack, cmd) || h_a_SplitString(stack, cmd);
+    return h_a_Split(ip, cmd) || h_a_Concat(ip, cmd) || h_a_ConcatX(ip, cmd) || 
+    h_a_RangeSize(ip, cmd) || h_a_ByIndex(ip, cmd) || h_a_FindSub(ip, cmd) ||
+    h_a_First(ip, cmd) || h_a_Last(ip, cmd) || h_a_FirstX(ip, cmd) ||
+    h_a_LastX(ip, cmd) || h_a_SplitString(ip, cmd) || h_a_Sort(ip, cmd) ||
+    h_a_Union(ip, cmd) || h_a_Intersection(ip, cmd) || h_a_Difference(ip, cmd) ||
+    h_a_Unique(ip, cmd);
 }
@@ -4,20 +4,17 @@
 
 #pragma once
 
-#include "stack.h"
+#include "interp.h"
 
 
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Array(Item** vars, Stack* stack, char cmd, char* line, int* linePos);
+int hHub_Array(Interp* ip, char cmd);
 
 
 
@@ -0,0 +1,711 @@
+/**
+ * @file Handlers - Funções que processam alguns comandos, neste caso, sobre blocos
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "handler_block.h"
+#include "pool.h"
+#include "sort.h"
+#include "vm.h"
+#include "interp.h"
+
+/** Abaixo deste tamanho o map e o filter nunca são divididos pelas threads */
+#define BlockParallelMinSize 4096
+/** Quantidade de pedaços por thread no map e filter paralelos (mais pedaços equilibram melhor o trabalho) */
+#define BlockChunksPerThread 8
+
+/**
+ * Trabalho de um map ou filter, dividido em pedaços seguidos de elementos
+ */
+typedef struct BlockJobT
+{
+    Item* input;        /*!< String, lista, vista ou número a percorrer */
+    Code* code;         /*!< Código do bloco */
+    int filter;         /*!< 1 no filter, 0 no map */
+    long count;         /*!< Quantidade de elementos */
+    long chunkSize;     /*!< Quantidade de elementos por pedaço */
+    Interp* workers;    /*!< Interpretador de cada worker (com o seu stack auxiliar) */
+    List** results;     /*!< Resultado de cada pedaço */
+} BlockJob;
+
+
+// Funções auxiliares
+
+/** @brief Retira do stack um bloco e, debaixo dele, uma string, lista, vista ou número.
+ * 
+ * Se os items não forem destes tipos, o stack fica como estava.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param outA Variável de saida com a string, lista, vista ou número
+ * @param outB Variável de saida com o bloco
+ * @returns 1 se tiver sucesso
+ */
+int h_bh_PopArgs(Interp* ip, Item** outA, Item** outB)
+{
+    Stack* stack = ip->stack;
+    Item* ib = stack_PeekLazy(stack);
+    if (ib == NULL || ib->type != TBlock || stack_Count(stack) < 2)
+        return 0;
+    ib = stack_PopLazy(stack);
+    Item* ia = stack_PeekLazy(stack);
+    if (!item_IsType(ia, IT_Arr | IT_Num) && ia->type != TRepeat)
+    {
+        stack_Push(stack, ib);
+        return 0;
+    }
+    *outA = stack_PopLazy(stack);
+    *outB = ib;
+    return 1;
+}
+
+/** @brief Calcula quantos elementos são percorridos (um número N é o range de 0 a N-1).
+ * 
+ * @param ia Apontador para a string, lista, vista ou número
+ * @returns Quantidade de elementos
+ */
+long h_bh_Length(Item* ia)
+{
+    if (item_IsType(ia, IT_Num))
+    {
+        long n = i_ToLong(ia);
+        return (n > 0) ? n : 0;
+    }
+    return item_Length(ia);
+}
+
+/** @brief Dá um elemento de uma string, lista, vista ou número.
+ * 
+ * Os elementos das listas são retirados da lista (ficam a NULL), para não serem copiados.
+ * 
+ * @param ia Apontador para a string, lista, vista ou número
+ * @param i Indice do elemento
+ * @returns Elemento
+ */
+Item* h_bh_Element(Item* ia, long i)
+{
+    if (ia->type == TList)
+    {
+        List* l = (List*)ia->pointer;
+        Item* item = l->array[i];
+        l->array[i] = NULL;
+        return item;
+    }
+    if (item_IsType(ia, IT_Num))
+        return icreate_Long(i);
+    return item_At(ia, i);
+}
+
+/** @brief Verifica se o item é uma string (ou uma vista de uma string).
+ * 
+ * @param ia Apontador para o item
+ * @returns 1 ou 0
+ */
+int h_bh_IsString(Item* ia)
+{
+    if (ia->type == TRepeat)
+        return ((Repeat*)ia->pointer)->source->type == TString;
+    return ia->type == TString;
+}
+
+/** @brief Verifica se um item pode ser usado em várias threads pelo map e filter paralelos.
+ * 
+ * Os blocos dentro do item (que o código pode executar) também não podem usar variáveis nem a entrada.
+ * 
+ * @param item Apontador para o item
+ * @returns 1 ou 0
+ */
+int h_bh_IsParallelSafe(Item* item)
+{
+    if (item->type == TBlock)
+        return code_IsParallelSafe(((Block*)item->pointer)->code);
+    if (item->type == TRepeat)
+        return h_bh_IsParallelSafe(((Repeat*)item->pointer)->source);
+    if (item->type == TList)
+    {
+        List* l = (List*)item->pointer;
+        for (int i = 0; i < l->count; i++)
+            if (l->array[i] != NULL && !h_bh_IsParallelSafe(l->array[i]))
+                return 0;
+    }
+    return 1;
+}
+
+/** @brief Executa um pedaço de um map ou filter.
+ * 
+ * @param context Apontador para o trabalho
+ * @param chunk Indice do pedaço
+ * @param worker Indice do worker (escolhe o stack auxiliar)
+ */
+void h_bh_RunChunk(void* context, int chunk, int worker)
+{
+    BlockJob* job = (BlockJob*)context;
+    long start = chunk * job->chunkSize;
+    long end = (start + job->chunkSize < job->count) ? start + job->chunkSize : job->count;
+    List* result = list_Create(end - start);
+    Interp* ip = &job->workers[worker];
+    Stack* scratch = ip->stack;
+    for (long i = start; i < end; i++)
+    {
+        Item* element = h_bh_Element(job->input, i);
+        if (!job->filter)
+        {
+            stack_Push(scratch, element);
+            vm_Run(ip, job->code);
+            stack_MoveToList(scratch, result);
+        }
+        else
+        {
+            stack_Push(scratch, item_Copy(element));
+            vm_Run(ip, job->code);
+            Item* top = stack_PeekLazy(scratch);
+            int keep = top != NULL && item_IsTrue(top);
+            stack_Clear(scratch);
+            if (keep)
+                list_Add(result, element);
+            else item_Dispose(element);
+        }
+        // O 'b' só é possível em série (um só pedaço)
+        if (vm_TakeBreak(ip))
+            break;
+    }
+    job->results[chunk] = result;
+}
+
+/** @brief Executa um map ou filter, dividido pelas threads da pool se compensar.
+ * 
+ * O trabalho é dividido quando o modo paralelo está ligado ('--threads'), a entrada tem
+ * pelo menos 'BlockParallelMinSize' elementos e nem o bloco nem os elementos usam variáveis
+ * ou a entrada. Cada pedaço tem o seu resultado, que no fim são juntados pela ordem original.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ia String, lista, vista ou número a percorrer
+ * @param ib Bloco
+ * @param filter 1 no filter, 0 no map
+ * @returns Lista com o resultado
+ */
+List* h_bh_RunJob(Interp* ip, Item* ia, Item* ib, int filter)
+{
+    BlockJob job;
+    job.input = ia;
+    job.code = ((Block*)ib->pointer)->code;
+    job.filter = filter;
+    job.count = h_bh_Length(ia);
+    Pool* pool = ip->pool;
+    int parallel = pool != NULL && job.count >= BlockParallelMinSize &&
+        code_IsParallelSafe(job.code) && h_bh_IsParallelSafe(ia);
+    int workers = parallel ? pool->count : 1;
+    int chunks = parallel ? workers * BlockChunksPerThread : 1;
+    job.chunkSize = (job.count + chunks - 1) / chunks;
+    if (job.chunkSize == 0)
+        job.chunkSize = 1;
+    job.workers = malloc(workers * sizeof(Interp));
+    for (int i = 0; i < workers; i++)
+        interp_Fork(&job.workers[i], ip);
+    job.results = calloc(chunks, sizeof(List*));
+    if (parallel)
+        pool_Run(pool, chunks, h_bh_RunChunk, &job);
+    else h_bh_RunChunk(&job, 0, 0);
+
+    long total = 0;
+    for (int i = 0; i < chunks; i++)
+        total += job.results[i]->count;
+    List* result = list_Create(total);
+    for (int i = 0; i < chunks; i++)
+    {
+        list_AddRange(result, job.results[i]);
+        list_Free(job.results[i]);
+    }
+    for (int i = 0; i < workers; i++)
+        interp_Join(ip, &job.workers[i]);
+    free(job.workers);
+    free(job.results);
+    return result;
+}
+
+/** @brief Retira do stack dois blocos (a condição e o corpo de um ciclo).
+ * 
+ * Se os items não forem blocos, o stack fica como estava.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param outCond Variável de saida com o bloco de baixo
+ * @param outBody Variável de saida com o bloco do topo
+ * @returns 1 se tiver sucesso
+ */
+int h_bh_PopBlocks(Interp* ip, Item** outCond, Item** outBody)
+{
+    Stack* stack = ip->stack;
+    Item* ib = stack_PeekLazy(stack);
+    if (ib == NULL || ib->type != TBlock || stack_Count(stack) < 2)
+        return 0;
+    ib = stack_PopLazy(stack);
+    if (stack_PeekLazy(stack)->type != TBlock)
+    {
+        stack_Push(stack, ib);
+        return 0;
+    }
+    *outCond = stack_PopLazy(stack);
+    *outBody = ib;
+    return 1;
+}
+
+/** @brief Executa a condição de um ciclo e retira o resultado do stack.
+ * 
+ * O resultado é testado e libertado logo, sem ser copiado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Código da condição (NULL para usar o que já está no topo)
+ * @returns 1 se a condição for verdadeira (um stack vazio é falso)
+ */
+int h_bh_Test(Interp* ip, Code* code)
+{
+    if (code != NULL)
+        vm_Run(ip, code);
+    Item* top = stack_PopLazy(ip->stack);
+    if (top == NULL)
+        return 0;
+    int r = item_IsTrue(top);
+    item_Dispose(top);
+    return r;
+}
+
+/** @brief Guarda o resultado no stack, como string se a entrada for uma string e o resultado só tiver texto.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param result Lista com o resultado (passa a pertencer ao stack, ou é libertada)
+ * @param string 1 se a entrada for uma string
+ */
+void h_bh_PushResult(Interp* ip, List* result, int string)
+{
+    Stack* stack = ip->stack;
+    int size = 0;
+    for (int i = 0; string && i < result->count; i++)
+        if (item_IsType(result->array[i], IT_Txt))
+            size += (result->array[i]->type == TChar) ? 1 : result->array[i]->size;
+        else string = 0;
+    if (!string)
+    {
+        stack_Push(stack, icreate_FromList(result));
+        return;
+    }
+    char* s = malloc(size + 1);
+    int offset = 0;
+    for (int i = 0; i < result->count; i++)
+    {
+        Item* item = result->array[i];
+        if (item->type == TChar)
+            s[offset++] = *(char*)item->pointer;
+        else
+        {
+            memcpy(s + offset, item->pointer, item->size);
+            offset += item->size;
+        }
+    }
+    s[size] = '\0';
+    list_Dispose(result);
+    stack_Push(stack, icreate_String(s, size));
+}
+
+
+// ~
+/** @brief Função que executa o bloco no topo da stack.
+ * 
+ * O bloco já vem compilado, então o texto não é lido outra vez.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Execute(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    if (cmd != '~')
+        return 0;
+    Item* ib = stack_PeekLazy(stack);
+    if (ib == NULL || ib->type != TBlock)
+        return 0;
+    stack_PopLazy(stack);
+    // O item só é libertado no fim, porque o código pertence ao bloco
+    vm_Run(ip, ((Block*)ib->pointer)->code);
+    item_Dispose(ib);
+    return 1;
+}
+
+
+// %
+/** @brief Função que aplica um bloco a todos os elementos (map).
+ * 
+ * Cada elemento é processado num stack auxiliar (reutilizado), e tudo o que o bloco
+ * deixar no stack passa diretamente para a lista do resultado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Map(Interp* ip, char cmd)
+{
+    Item* ia, *ib;
+    if (cmd != '%' || !h_bh_PopArgs(ip, &ia, &ib))
+        return 0;
+    List* result = h_bh_RunJob(ip, ia, ib, 0);
+    h_bh_PushResult(ip, result, h_bh_IsString(ia));
+    item_Dispose(ia); item_Dispose(ib);
+    return 1;
+}
+
+// ,
+/** @brief Função que escolhe os elementos para os quais o bloco dá verdadeiro (filter).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Filter(Interp* ip, char cmd)
+{
+    Item* ia, *ib;
+    if (cmd != ',' || !h_bh_PopArgs(ip, &ia, &ib))
+        return 0;
+    List* result = h_bh_RunJob(ip, ia, ib, 1);
+    h_bh_PushResult(ip, result, h_bh_IsString(ia));
+    item_Dispose(ia); item_Dispose(ib);
+    return 1;
+}
+
+// *
+/** @brief Função que junta os elementos com o bloco, da esquerda para a direita (fold).
+ * 
+ * O primeiro elemento fica no stack, e o bloco é executado depois de cada um dos seguintes.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Fold(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* ia, *ib;
+    if (cmd != '*' || !h_bh_PopArgs(ip, &ia, &ib))
+        return 0;
+    Code* code = ((Block*)ib->pointer)->code;
+    long n = h_bh_Length(ia);
+    for (long i = 0; i < n; i++)
+    {
+        stack_Push(stack, h_bh_Element(ia, i));
+        if (i > 0)
+            vm_Run(ip, code);
+        if (vm_TakeBreak(ip))
+            break;
+    }
+    item_Dispose(ia); item_Dispose(ib);
+    return 1;
+}
+
+// /
+/** @brief Função que executa o bloco para cada elemento, no stack principal (each).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Each(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* ia, *ib;
+    if (cmd != '/' || !h_bh_PopArgs(ip, &ia, &ib))
+        return 0;
+    Code* code = ((Block*)ib->pointer)->code;
+    long n = h_bh_Length(ia);
+    for (long i = 0; i < n; i++)
+    {
+        stack_Push(stack, h_bh_Element(ia, i));
+        vm_Run(ip, code);
+        if (vm_TakeBreak(ip))
+            break;
+    }
+    item_Dispose(ia); item_Dispose(ib);
+    return 1;
+}
+
+
+// ?
+/** @brief Função que escolhe um de dois items conforme a condição, executando-o se for um bloco.
+ * 
+ * Só o ramo escolhido é executado. Se nenhum dos ramos for um bloco, o '?' normal trata do comando.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_IfElse(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    if (cmd != '?' || stack_Count(stack) < 3)
+        return 0;
+    Item* iB = stack_PopLazy(stack);
+    Item* iA = stack_PeekLazy(stack);
+    if (iA->type != TBlock && iB->type != TBlock)
+    {
+        stack_Push(stack, iB);
+        return 0;
+    }
+    iA = stack_PopLazy(stack);
+    Item* iCond = stack_PopLazy(stack);
+    Item* chosen = item_IsTrue(iCond) ? iA : iB;
+    item_Dispose(iCond);
+    item_Dispose((chosen == iA) ? iB : iA);
+    if (chosen->type != TBlock)
+    {
+        stack_Push(stack, chosen);
+        return 1;
+    }
+    vm_Run(ip, ((Block*)chosen->pointer)->code);
+    item_Dispose(chosen);
+    return 1;
+}
+
+// $
+/** @brief Função que ordena uma string ou lista pelo resultado do bloco (ordenação estável).
+ * 
+ * A chave de cada elemento é calculada uma só vez, antes de ordenar, e a ordenação
+ * usa as chaves já calculadas (radix sort se forem todas longs, comparação de texto se
+ * forem todas strings).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_SortBy(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* ia, *ib;
+    if (cmd != '$' || !h_bh_PopArgs(ip, &ia, &ib))
+        return 0;
+    if (item_IsType(ia, IT_Num))
+    {
+        stack_Push(stack, ia);
+        stack_Push(stack, ib);
+        return 0;
+    }
+    int string = h_bh_IsString(item_Force(ia));
+    List* list = string ? list_FromString((char*)ia->pointer, ia->size) : (List*)ia->pointer;
+    Code* code = ((Block*)ib->pointer)->code;
+    Item** keys = malloc(list->count * sizeof(Item*));
+    // As chaves são calculadas num stack auxiliar, que passa a ser o do interpretador
+    Stack* scratch = interp_TakeStack(ip);
+    ip->stack = scratch;
+    for (int i = 0; i < list->count; i++)
+    {
+        stack_Push(scratch, item_Copy(list->array[i]));
+        vm_Run(ip, code);
+        Item* key = stack_Pop(scratch);
+        keys[i] = (key != NULL) ? key : icreate_Long(0);
+        stack_Clear(scratch);
+    }
+    ip->stack = stack;
+    vm_TakeBreak(ip);
+    interp_GiveStack(ip, scratch);
+    sort_ItemsByKey(list->array, keys, list->count);
+    for (int i = 0; i < list->count; i++)
+        item_Dispose(keys[i]);
+    free(keys);
+    item_Dispose(ib);
+    if (string)
+    {
+        item_Dispose(ia);
+        h_bh_PushResult(ip, list, 1);
+    }
+    else
+    {
+        item_InvalidateHash(ia);
+        stack_Push(stack, ia);
+    }
+    return 1;
+}
+
+// w
+/** @brief Função que executa o corpo enquanto a condição for verdadeira ({cond} {corpo} w).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_While(Interp* ip, char cmd)
+{
+    Item* ic, *ib;
+    if (cmd != 'w' || !h_bh_PopBlocks(ip, &ic, &ib))
+        return 0;
+    Code* cond = ((Block*)ic->pointer)->code, *body = ((Block*)ib->pointer)->code;
+    while (h_bh_Test(ip, cond) && !vm_TakeBreak(ip))
+    {
+        vm_Run(ip, body);
+        if (vm_TakeBreak(ip))
+            break;
+    }
+    item_Dispose(ic); item_Dispose(ib);
+    return 1;
+}
+
+// u
+/** @brief Função que executa o corpo até a condição ser verdadeira ({cond} {corpo} u).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Until(Interp* ip, char cmd)
+{
+    Item* ic, *ib;
+    if (cmd != 'u' || !h_bh_PopBlocks(ip, &ic, &ib))
+        return 0;
+    Code* cond = ((Block*)ic->pointer)->code, *body = ((Block*)ib->pointer)->code;
+    while (!h_bh_Test(ip, cond) && !vm_TakeBreak(ip))
+    {
+        vm_Run(ip, body);
+        if (vm_TakeBreak(ip))
+            break;
+    }
+    item_Dispose(ic); item_Dispose(ib);
+    return 1;
+}
+
+// d
+/** @brief Função que executa o corpo e repete enquanto este deixar no topo um valor verdadeiro ({corpo} d).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Do(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    if (cmd != 'd')
+        return 0;
+    Item* ib = stack_PeekLazy(stack);
+    if (ib == NULL || ib->type != TBlock)
+        return 0;
+    stack_PopLazy(stack);
+    Code* body = ((Block*)ib->pointer)->code;
+    while (1)
+    {
+        vm_Run(ip, body);
+        if (vm_TakeBreak(ip) || !h_bh_Test(ip, NULL))
+            break;
+    }
+    item_Dispose(ib);
+    return 1;
+}
+
+// b
+/** @brief Função que sai do ciclo atual (fora de um ciclo, termina o programa).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int h_b_Break(Interp* ip, char cmd)
+{
+    if (cmd != 'b')
+        return 0;
+    vm_Break(ip);
+    return 1;
+}
+
+
+
+// e&
+/** @brief Função que executa o bloco do topo apenas se o item de baixo for diferente de 0 (e&).
+ * 
+ * Tal como o 'e&' normal, guarda o resultado do bloco se os dois forem diferentes de 0, ou 0 se não.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int h_eb_And(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* iA, *iB;
+    if (cmd != '&' || !h_bh_PopArgs(ip, &iA, &iB))
+        return 0;
+    long a = i_ToLong(iA);
+    item_Dispose(iA);
+    if (a != 0)
+        vm_Run(ip, ((Block*)iB->pointer)->code);
+    item_Dispose(iB);
+    Item* result = (a != 0) ? stack_PopLazy(stack) : NULL;
+    if (result != NULL && i_ToLong(result) != 0)
+        stack_Push(stack, result);
+    else
+    {
+        if (result != NULL)
+            item_Dispose(result);
+        stack_Push(stack, icreate_Long(0));
+    }
+    return 1;
+}
+
+// e|
+/** @brief Função que executa o bloco do topo apenas se o item de baixo for 0 (e|).
+ * 
+ * Tal como o 'e|' normal, guarda o primeiro diferente de 0, ou 0 se os dois forem 0.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int h_eb_Or(Interp* ip, char cmd)
+{
+    Stack* stack = ip->stack;
+    Item* iA, *iB;
+    if (cmd != '|' || !h_bh_PopArgs(ip, &iA, &iB))
+        return 0;
+    if (i_ToLong(iA) != 0)
+    {
+        stack_Push(stack, iA);
+        item_Dispose(iB);
+        return 1;
+    }
+    item_Dispose(iA);
+    vm_Run(ip, ((Block*)iB->pointer)->code);
+    item_Dispose(iB);
+    Item* result = stack_PopLazy(stack);
+    if (result != NULL && i_ToLong(result) != 0)
+        stack_Push(stack, result);
+    else
+    {
+        if (result != NULL)
+            item_Dispose(result);
+        stack_Push(stack, icreate_Long(0));
+    }
+    return 1;
+}
+
+
+
+/** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int hHub_Block(Interp* ip, char cmd)
+{
+    return h_b_Execute(ip, cmd) || h_b_IfElse(ip, cmd) || h_b_Map(ip, cmd) ||
+    h_b_SortBy(ip, cmd) ||
+    h_b_Filter(ip, cmd) || h_b_Fold(ip, cmd) || h_b_Each(ip, cmd) ||
+    h_b_While(ip, cmd) || h_b_Until(ip, cmd) || h_b_Do(ip, cmd) ||
+    h_b_Break(ip, cmd);
+}
+
+/** @brief Esta função é um hub para os comandos que começam por 'e' e usam blocos.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_EBlock(Interp* ip, char cmd)
+{
+    return h_eb_And(ip, cmd) || h_eb_Or(ip, cmd);
+}
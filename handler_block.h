@@ -0,0 +1,23 @@
+/**
+ * @file Handlers - Funções que processam alguns comandos, neste caso, sobre blocos
+ */
+
+#pragma once
+
+#include "interp.h"
+
+/** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int hHub_Block(Interp* ip, char cmd);
+
+/** @brief Esta função é um hub para os comandos que começam por 'e' e usam blocos.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_EBlock(Interp* ip, char cmd);
@@ -12,12 +12,13 @@
 
 /** @brief Função que verifica se 2 items sao iguais.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_l_Equals(Stack* stack, char cmd)
+int h_l_Equals(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '=')
         return 0;
     Item* itemB = stack_Pop(stack);
@@ -30,12 +31,13 @@ int h_l_Equals(Stack* stack, char cmd)
 
 /** @brief Função que verifica se um item e menor que outro.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_l_Less(Stack* stack, char cmd)
+int h_l_Less(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '<')
         return 0;
     Item* itemB = stack_Pop(stack);
@@ -46,25 +48,24 @@ int h_l_Less(Stack* stack, char cmd)
         stack_Push(stack, itemB);
         return 0;
     }
+    Item* result;
     if (itemA->type == itemB->type && itemA->type == TString)
-    {
-        char* a = (char*)itemA->pointer, *b = (char*)itemB->pointer;
-        stack_Push(stack, icreate_Long((utils_StringCompare(a, b) == -1)));
-        return 1;
-    }
-    double a = i_ToDouble(itemA), b = i_ToDouble(itemB);
-    stack_Push(stack, icreate_Long(a < b));
+        result = icreate_Long(utils_StringCompare((char*)itemA->pointer, (char*)itemB->pointer) == -1);
+    else result = icreate_Long(i_ToDouble(itemA) < i_ToDouble(itemB));
+    item_Dispose(itemA); item_Dispose(itemB);
+    stack_Push(stack, result);
     return 1;
 }
 
 /** @brief Função que verifica se um item e maior que outro.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_l_More(Stack* stack, char cmd)
+int h_l_More(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '>')
         return 0;
     Item* itemB = stack_Pop(stack);
@@ -75,25 +76,24 @@ int h_l_More(Stack* stack, char cmd)
         stack_Push(stack, itemB);
         return 0;
     }
+    Item* result;
     if (itemA->type == itemB->type && itemA->type == TString)
-    {
-        char* a = (char*)itemA->pointer, *b = (char*)itemB->pointer;
-        stack_Push(stack, icreate_Long((utils_StringCompare(a, b) == 1)));
-        return 1;
-    }
-    double a = i_ToDouble(itemA), b = i_ToDouble(itemB);
-    stack_Push(stack, icreate_Long(a > b));
+        result = icreate_Long(utils_StringCompare((char*)itemA->pointer, (char*)itemB->pointer) == 1);
+    else result = icreate_Long(i_ToDouble(itemA) > i_ToDouble(itemB));
+    item_Dispose(itemA); item_Dispose(itemB);
+    stack_Push(stack, result);
     return 1;
 }
 
 /** @brief Função que troca um 0 por 1 e 1 por 0.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_l_Not(Stack* stack, char cmd)
+int h_l_Not(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '!')
         return 0;
     Item* item = stack_Peek(stack);
@@ -106,12 +106,13 @@ int h_l_Not(Stack* stack, char cmd)
 
 /** @brief Guarda itemA se a condição for verdadeira e B se não.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_l_IfElse(Stack* stack, char cmd)
+int h_l_IfElse(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '?')
         return 0;
     Item* itemB = stack_Pop(stack);
@@ -138,12 +139,13 @@ int h_l_IfElse(Stack* stack, char cmd)
 
 /** @brief Se os 2 items forem diferentes de 0, guarda o segundo.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_el_And(Stack* stack, char cmd)
+int h_el_And(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '&')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -162,12 +164,13 @@ int h_el_And(Stack* stack, char cmd)
 
 /** @brief Se um dos 2 items forem diferentes de 0, guarda o primeiro diferente de 0.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_el_Or(Stack* stack, char cmd)
+int h_el_Or(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '|')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -192,12 +195,13 @@ int h_el_Or(Stack* stack, char cmd)
 
 /** @brief Guarda o item menor.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_el_Less(Stack* stack, char cmd)
+int h_el_Less(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '<')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -228,12 +232,13 @@ int h_el_Less(Stack* stack, char cmd)
 
 /** @brief Guarda o item maior.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_el_More(Stack* stack, char cmd)
+int h_el_More(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '>')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -266,21 +271,26 @@ int h_el_More(Stack* stack, char cmd)
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Logic(Stack* stack, char cmd, char* line, int* linePos)
+int hHub_Logic(Interp* ip, char cmd)
+{
+    return h_l_Equals(ip, cmd) || h_l_Less(ip, cmd) ||
+    h_l_More(ip, cmd) || h_l_Not(ip, cmd) || h_l_IfElse(ip, cmd);
+}
+
+/** @brief Esta função é um hub para os comandos que começam por 'e'.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_ELogic(Interp* ip, char cmd)
 {
-    if (cmd != 'e')
-        return h_l_Equals(stack, cmd) || h_l_Less(stack, cmd) ||
-        h_l_More(stack, cmd) || h_l_Not(stack, cmd) || h_l_IfElse(stack, cmd);
-    cmd = line[*linePos];
-    *linePos += 1;
-    return h_el_And(stack, cmd) || h_el_Or(stack, cmd) ||
-    h_el_Less(stack, cmd) || h_el_More(stack, cmd);
+    return h_el_And(ip, cmd) || h_el_Or(ip, cmd) ||
+    h_el_Less(ip, cmd) || h_el_More(ip, cmd);
 }
 
 
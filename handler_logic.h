@@ -4,19 +4,25 @@
 
 #pragma once
 
-#include "stack.h"
+#include "interp.h"
 
 
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Logic(Stack* stack, char cmd, char* line, int* linePos);
+int hHub_Logic(Interp* ip, char cmd);
+
+/** @brief Esta função é um hub para os comandos que começam por 'e'.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_ELogic(Interp* ip, char cmd);
 
 
 
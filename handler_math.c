@@ -14,12 +14,13 @@
 
 /** @brief Função que adiciona 1 ao item se este for um número.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Incr(Stack* stack, char cmd)
+int h_m_Incr(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != ')')
         return 0;
     return ifunc_Increment(stack_Peek(stack));
@@ -27,12 +28,13 @@ int h_m_Incr(Stack* stack, char cmd)
 
 /** @brief Função que remove 1 ao item se este for um número.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Decr(Stack* stack, char cmd)
+int h_m_Decr(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '(')
         return 0;
     return ifunc_Decrement(stack_Peek(stack));
@@ -41,12 +43,13 @@ int h_m_Decr(Stack* stack, char cmd)
 
 /** @brief Função que calcula a soma de dois items números.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Add(Stack* stack, char cmd)
+int h_m_Add(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '+')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -63,12 +66,13 @@ int h_m_Add(Stack* stack, char cmd)
 
 /** @brief Função que calcula a subtração de dois items números.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Sub(Stack* stack, char cmd)
+int h_m_Sub(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '-')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -85,17 +89,19 @@ int h_m_Sub(Stack* stack, char cmd)
 
 /** @brief Função que calcula a multiplicação de dois items números.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Mult(Stack* stack, char cmd)
+int h_m_Mult(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '*')
         return 0;
-    Item* iB = stack_Pop(stack);
-    Item* iA = stack_Pop(stack);
-    if (ifunc_Multiply(iA, iB))
+    // As vistas não são materializadas aqui, para o '*' de arrays as poder repetir
+    Item* iB = stack_PopLazy(stack);
+    Item* iA = stack_PopLazy(stack);
+    if (iA->type != TRepeat && iB->type != TRepeat && ifunc_Multiply(iA, iB))
     {
         stack_Push(stack, iB); item_Dispose(iA);
         return 1;
@@ -107,12 +113,13 @@ int h_m_Mult(Stack* stack, char cmd)
 
 /** @brief Função que calcula a divisão de dois items números.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Div(Stack* stack, char cmd)
+int h_m_Div(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '/')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -130,12 +137,13 @@ int h_m_Div(Stack* stack, char cmd)
 
 /** @brief Função que calcula o resto da divisão de dois items números.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Mod(Stack* stack, char cmd)
+int h_m_Mod(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '%')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -152,12 +160,13 @@ int h_m_Mod(Stack* stack, char cmd)
 
 /** @brief Função que calcula um item elevado a outro (os dois números).
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Pow(Stack* stack, char cmd)
+int h_m_Pow(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '#')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -175,12 +184,13 @@ int h_m_Pow(Stack* stack, char cmd)
 
 /** @brief Função que calcula itemA & itemB.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_And(Stack* stack, char cmd)
+int h_m_And(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '&')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -197,12 +207,13 @@ int h_m_And(Stack* stack, char cmd)
 
 /** @brief Função que calcula itemA | itemB.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Or(Stack* stack, char cmd)
+int h_m_Or(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '|')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -219,12 +230,13 @@ int h_m_Or(Stack* stack, char cmd)
 
 /** @brief Função que calcula itemA ^ itemB.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Xor(Stack* stack, char cmd)
+int h_m_Xor(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '^')
         return 0;
     Item* iB = stack_Pop(stack);
@@ -241,12 +253,13 @@ int h_m_Xor(Stack* stack, char cmd)
 
 /** @brief Função que calcula ~item.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_m_Not(Stack* stack, char cmd)
+int h_m_Not(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '~')
         return 0;
     return ifunc_Not(stack_Peek(stack));
@@ -256,18 +269,18 @@ int h_m_Not(Stack* stack, char cmd)
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int hHub_Math(Stack* stack, char cmd)
+int hHub_Math(Interp* ip, char cmd)
 {
-    return h_m_Incr(stack, cmd) || h_m_Decr(stack, cmd) || 
-    h_m_Add(stack, cmd) || h_m_Sub(stack, cmd) || 
-    h_m_Mult(stack, cmd) || h_m_Div(stack, cmd) ||
-    h_m_Mod(stack, cmd) || h_m_Pow(stack, cmd) ||
-    h_m_And(stack, cmd) || h_m_Or(stack, cmd) ||
-    h_m_Xor(stack, cmd) || h_m_Not(stack, cmd);;
+    return h_m_Incr(ip, cmd) || h_m_Decr(ip, cmd) || 
+    h_m_Add(ip, cmd) || h_m_Sub(ip, cmd) || 
+    h_m_Mult(ip, cmd) || h_m_Div(ip, cmd) ||
+    h_m_Mod(ip, cmd) || h_m_Pow(ip, cmd) ||
+    h_m_And(ip, cmd) || h_m_Or(ip, cmd) ||
+    h_m_Xor(ip, cmd) || h_m_Not(ip, cmd);;
 }
 
 
@@ -4,13 +4,13 @@
 
 #pragma once
 
-#include "item.h"
+#include "interp.h"
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int hHub_Math(Stack* stack, char cmd);
+int hHub_Math(Interp* ip, char cmd);
 
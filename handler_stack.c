@@ -14,12 +14,13 @@
 
 /** @brief Função que converte o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_s_ToLong(Stack* stack, char cmd)
+int h_s_ToLong(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 'i')
         return 0;
     return ifunc_ConvertToLong(stack_Peek(stack));
@@ -27,12 +28,13 @@ int h_s_ToLong(Stack* stack, char cmd)
 
 /** @brief Função que converte o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_s_ToDouble(Stack* stack, char cmd)
+int h_s_ToDouble(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 'f')
         return 0;
     return ifunc_ConvertToDouble(stack_Peek(stack));
@@ -40,12 +42,13 @@ int h_s_ToDouble(Stack* stack, char cmd)
 
 /** @brief Função que converte o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_s_ToChar(Stack* stack, char cmd)
+int h_s_ToChar(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 'c')
         return 0;
     return ifunc_ConvertToChar(stack_Peek(stack));
@@ -53,12 +56,13 @@ int h_s_ToChar(Stack* stack, char cmd)
 
 /** @brief Função que converte o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int h_s_ToString(Stack* stack, char cmd)
+int h_s_ToString(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 's')
         return 0;
     Item* item = stack_Pop(stack);
@@ -72,45 +76,48 @@ int h_s_ToString(Stack* stack, char cmd)
 
 /** @brief Duplica o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_Duplicate(Stack* stack, char cmd)
+int h_s_Duplicate(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '_')
         return 0;
-    Item* item = item_Copy(stack_Peek(stack));
+    Item* item = item_Copy(stack_PeekLazy(stack));
     stack_Push(stack, item);
     return 1;
 }
 
 /** @brief Remove o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_Pop(Stack* stack, char cmd)
+int h_s_Pop(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != ';')
         return 0;
-    item_Dispose(stack_Pop(stack));
+    item_Dispose(stack_PopLazy(stack));
     return 1;
 }
 
 /** @brief Troca de posição os 2 items no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_Switch(Stack* stack, char cmd)
+int h_s_Switch(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '\\')
         return 0;
-    Item* b = stack_Pop(stack);
-    Item* a = stack_Pop(stack);
+    Item* b = stack_PopLazy(stack);
+    Item* a = stack_PopLazy(stack);
     stack_Push(stack, b);
     stack_Push(stack, a);
     return 1;
@@ -118,17 +125,18 @@ int h_s_Switch(Stack* stack, char cmd)
 
 /** @brief Troca de posição os 3 items no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_Switch3(Stack* stack, char cmd)
+int h_s_Switch3(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '@')
         return 0;
-    Item* c = stack_Pop(stack);
-    Item* b = stack_Pop(stack);
-    Item* a = stack_Pop(stack);
+    Item* c = stack_PopLazy(stack);
+    Item* b = stack_PopLazy(stack);
+    Item* a = stack_PopLazy(stack);
     stack_Push(stack, b);
     stack_Push(stack, c);
     stack_Push(stack, a);
@@ -137,12 +145,13 @@ int h_s_Switch3(Stack* stack, char cmd)
 
 /** @brief Copia um item da stack (0 é o topo).
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_CapyN(Stack* stack, char cmd)
+int h_s_CapyN(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != '$')
         return 0;
     Item* itemIndex = stack_Pop(stack);
@@ -152,51 +161,59 @@ int h_s_CapyN(Stack* stack, char cmd)
         return 0;
     }
     long i = i_ToLong(itemIndex);
+    item_Dispose(itemIndex);
     stack_Push(stack, stack_CopyN(stack, i));
     return 1;
 }
 
-/** @brief Guarda uma linha da consola na stack.
+/** @brief Guarda uma linha da entrada do programa na stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_GetLine(Stack* stack, char cmd)
+int h_s_GetLine(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 'l')
         return 0;
-    int size; char* line = utils_GetLine(&size);
+    int size; char* line = (ip->io.reader != NULL) ? reader_GetLine(ip->io.reader, &size) : utils_GetLine(ip->io.in, &size);
+    if (line == NULL) // fim da entrada: fica uma string vazia
+        line = calloc(1, sizeof(char));
     stack_Push(stack, icreate_String(line, size));
     return 1;
 }
 
-/** @brief Guarda várias linhas da consola na stack.
+/** @brief Guarda as linhas que faltam da entrada do programa na stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_GetAllLines(Stack* stack, char cmd)
+int h_s_GetAllLines(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 't')
         return 0;
-    int size; char* line = utils_GetAllLines(&size);
+    int size; char* line = (ip->io.reader != NULL) ? reader_GetAll(ip->io.reader, &size) : utils_GetAllLines(ip->io.in, &size);
+    if (line == NULL) // fim da entrada: fica uma string vazia
+        line = calloc(1, sizeof(char));
     stack_Push(stack, icreate_String(line, size));
     return 1;
 }
 
 /** @brief Imprime o item no topo da stack.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se o comando foi processado
  */
-int h_s_PrintTop(Stack* stack, char cmd)
+int h_s_PrintTop(Interp* ip, char cmd)
 {
+    Stack* stack = ip->stack;
     if (cmd != 'p')
         return 0;
-    item_Print(stack_Peek(stack));
+    item_Print(stack_PeekLazy(stack), ip->io.out);
     return 1;
 }
 
@@ -204,17 +221,17 @@ int h_s_PrintTop(Stack* stack, char cmd)
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada.
  * 
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
  * @returns 1 se tiver sucesso
  */
-int hHub_Stack(Stack* stack, char cmd)
+int hHub_Stack(Interp* ip, char cmd)
 {
-    return h_s_Duplicate(stack, cmd) || h_s_Pop(stack, cmd) || 
-    h_s_Switch(stack, cmd) || h_s_Switch3(stack, cmd) || 
-    h_s_CapyN(stack, cmd) || h_s_GetLine(stack, cmd) ||
-    h_s_GetAllLines(stack, cmd) || h_s_PrintTop(stack, cmd) || 
-    h_s_ToLong(stack, cmd) || h_s_ToDouble(stack, cmd) ||
-    h_s_ToChar(stack, cmd) || h_s_ToString(stack, cmd);
+    return h_s_Duplicate(ip, cmd) || h_s_Pop(ip, cmd) || 
+    h_s_Switch(ip, cmd) || h_s_Switch3(ip, cmd) || 
+    h_s_CapyN(ip, cmd) || h_s_GetLine(ip, cmd) ||
+    h_s_GetAllLines(ip, cmd) || h_s_PrintTop(ip, cmd) || 
+    h_s_ToLong(ip, cmd) || h_s_ToDouble(ip, cmd) ||
+    h_s_ToChar(ip, cmd) || h_s_ToString(ip, cmd);
 }
 
@@ -12,59 +12,71 @@
 
 /** @brief Função que guarda no topo da stack o item numa das variáveis
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int h_v_GetValue(Item** vars, Stack* stack, char cmd)
+int h_v_GetValue(Interp* ip, char cmd)
 {
     if (cmd < 'A' || cmd > 'Z')
         return 0;
     int index = cmd - 65;
-    Item* var = vars[index];
+    Item* var = ip->vars[index];
     Item* copy = item_Copy(var);
-    stack_Push(stack, copy);
+    stack_Push(ip->stack, copy);
     return 1;
 }
 
-/** @brief Função que guarda o item no topo da stack numa das variáveis
+/** @brief Função que guarda o item no topo da stack numa das variáveis (o ':' já vem resolvido do código compilado)
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
- * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
+ * @param ip Apontador para o interpretador
+ * @param var Letra da variável
  * @returns 1 se tiver sucesso
  */
-int h_v_SetValue(Item** vars, Stack* stack, char cmd, char* line, int* linePos)
+int h_v_SetValue(Interp* ip, char var)
 {
-    if (cmd != ':')
-        return 0;
-    char cv = line[*linePos];
-    if (cv < 'A' || cv > 'Z')
+    if (var < 'A' || var > 'Z')
         return 0;
-    *linePos += 1;
-    int index = cv - 65;
-    item_Dispose(vars[index]);
-    vars[index] = item_Copy(stack_Peek(stack));
+    int index = var - 65;
+    item_Dispose(ip->vars[index]);
+    ip->vars[index] = item_Copy(stack_PeekLazy(ip->stack));
     return 1;
 }
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Vars(Item** vars, Stack* stack, char cmd, char* line, int* linePos)
+int hHub_Vars(Interp* ip, char cmd)
+{
+    return h_v_GetValue(ip, cmd);
+}
+
+/** @brief Escreve na 'stderr' a memória ocupada pelo stack e pelas variáveis, sem os alterar (comando 'em').
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int h_ev_Memory(Interp* ip, char cmd)
+{
+    if (cmd != 'm')
+        return 0;
+    interp_PrintMemory(ip, stderr);
+    return 1;
+}
+
+/** @brief Esta função é um hub para os comandos que começam por 'e' e mostram o estado do interpretador.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_EVars(Interp* ip, char cmd)
 {
-    return h_v_GetValue(vars, stack, cmd) || h_v_SetValue(vars, stack, cmd, line, linePos);
+    return h_ev_Memory(ip, cmd);
 }
 
 
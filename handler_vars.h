@@ -4,18 +4,31 @@
 
 #pragma once
 
-#include "stack.h"
+#include "interp.h"
 
 /** @brief Esta função é um hub para todas as outras funções que resolvem a entrada
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
  * @returns 1 se tiver sucesso
  */
-int hHub_Vars(Item** vars, Stack* stack, char cmd, char* line, int* linePos);
+int hHub_Vars(Interp* ip, char cmd);
+
+/** @brief Função que guarda o item no topo da stack numa das variáveis (o ':' já vem resolvido do código compilado)
+ * 
+ * @param ip Apontador para o interpretador
+ * @param var Letra da variável
+ * @returns 1 se tiver sucesso
+ */
+int h_v_SetValue(Interp* ip, char var);
+
+/** @brief Esta função é um hub para os comandos que começam por 'e' e mostram o estado do interpretador.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char depois do 'e'
+ * @returns 1 se tiver sucesso
+ */
+int hHub_EVars(Interp* ip, char cmd);
 
 
 
@@ -0,0 +1,176 @@
+/**
+ * @file Contexto de um interpretador: tudo o que um programa precisa para correr, junto num só objeto
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocs.h"
+#include "interp.h"
+#include "memstats.h"
+#include "vars.h"
+
+/** @brief Cria um interpretador com um stack e variáveis novas.
+ * 
+ * @warning O novo interpretador é criado com o "malloc", logo tem que ser libertado depois usando a função 'interp_Dispose'.
+ * @param in Entrada do programa
+ * @param out Saída do programa
+ * @returns Novo interpretador
+ */
+Interp* interp_Create(FILE* in, FILE* out)
+{
+    Interp* ip = calloc(1, sizeof(Interp));
+    ip->stack = stack_Create(StackInitialSize);
+    ip->vars = vars_CreateArray();
+    ip->io.in = in;
+    ip->io.out = out;
+    ip->pool = pool_Default();
+    ip->owner = 1;
+    ip->nextSample = LONG_MAX;
+    return ip;
+}
+
+/** @brief Liberta os stacks auxiliares guardados.
+ * 
+ * @param ip Apontador para o interpretador
+ */
+void interp_p_DisposeSpares(Interp* ip)
+{
+    for (int i = 0; i < ip->spareCount; i++)
+        stack_Dispose(ip->spares[i]);
+    ip->spareCount = 0;
+}
+
+/** @brief Liberta o interpretador, o seu stack, as variáveis, o programa, o profiler e o tracer (os canais não são fechados).
+ * 
+ * @param ip Apontador para o interpretador
+ */
+void interp_Dispose(Interp* ip)
+{
+    stack_Dispose(ip->stack);
+    if (ip->owner)
+        vars_Dispose(ip->vars);
+    if (ip->code != NULL)
+        code_Dispose(ip->code);
+    interp_p_DisposeSpares(ip);
+    if (ip->profile != NULL)
+        profile_Dispose(ip->profile);
+    if (ip->trace != NULL)
+        trace_Dispose(ip->trace);
+    free(ip);
+}
+
+/** @brief Prepara um worker que partilha as variáveis, os canais, a pool e o tracer, mas tem o seu próprio stack.
+ * 
+ * Usado pelos maps e filters, em que cada thread precisa do seu stack (e do seu profiler, se estiver ligado).
+ * 
+ * @param worker Interpretador a preparar
+ * @param parent Interpretador de onde vem o trabalho
+ */
+void interp_Fork(Interp* worker, Interp* parent)
+{
+    memset(worker, 0, sizeof(Interp));
+    worker->stack = stack_Create(StackInitialSize);
+    worker->vars = parent->vars;
+    worker->io = parent->io;
+    worker->pool = parent->pool;
+    worker->trace = parent->trace;
+    // As amostras da memória só são tiradas no interpretador original
+    worker->nextSample = LONG_MAX;
+    if (parent->profile != NULL)
+        worker->profile = profile_Create(parent->profile->positionCount);
+}
+
+/** @brief Junta os contadores (e o profiler) de um worker aos do interpretador original e liberta o worker.
+ * 
+ * @param parent Interpretador de onde veio o trabalho
+ * @param worker Worker preparado pelo 'interp_Fork'
+ */
+void interp_Join(Interp* parent, Interp* worker)
+{
+    parent->stats.instructions += worker->stats.instructions;
+    parent->stats.runs += worker->stats.runs;
+    parent->stats.stacks += worker->stats.stacks + 1;
+    if (worker->profile != NULL)
+    {
+        profile_Merge(parent->profile, worker->profile);
+        profile_Dispose(worker->profile);
+    }
+    stack_Dispose(worker->stack);
+    interp_p_DisposeSpares(worker);
+}
+
+/** @brief Escreve os contadores numa linha, como pares nome=valor.
+ * 
+ * As alocações (de todo o programa) só aparecem se este foi compilado com a contagem, e os bytes
+ * vivos e o pico só com o seguimento (ver o 'allocs.h').
+ * 
+ * @param ip Apontador para o interpretador
+ * @param out Ficheiro onde se escreve
+ */
+void interp_PrintStats(Interp* ip, FILE* out)
+{
+    fprintf(out, "stats: instructions=%ld runs=%ld stacks=%ld", ip->stats.instructions, ip->stats.runs, ip->stats.stacks);
+    if (allocs_Enabled())
+        fprintf(out, " allocs=%ld alloc_bytes=%ld", allocs_Count(), allocs_Bytes());
+    if (allocs_Tracking())
+        fprintf(out, " live_bytes=%ld peak_bytes=%ld", allocs_Live(), allocs_Peak());
+    fprintf(out, "\n");
+}
+
+/** @brief Escreve numa linha o que está no stack atual e nas variáveis: items e bytes de cada tipo, espaço por usar e partilha.
+ * 
+ * Dentro de um array ou de um bloco auxiliar o stack atual é o dele (ver o 'memstats.h').
+ * 
+ * @param ip Apontador para o interpretador
+ * @param out Ficheiro onde se escreve
+ */
+void interp_PrintMemory(Interp* ip, FILE* out)
+{
+    MemStats stats;
+    memstats_Collect(ip->stack, ip->vars, &stats);
+    fprintf(out, "memory: instructions=%ld", ip->stats.instructions);
+    memstats_Print(&stats, out);
+}
+
+/** @brief Liga as amostras da memória, escritas na 'stderr' com o 'interp_PrintMemory' durante a execução.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param every Instruções entre cada amostra (0 para desligar)
+ */
+void interp_SampleMemory(Interp* ip, long every)
+{
+    ip->sampleEvery = every;
+    ip->nextSample = (every > 0) ? ip->stats.instructions + every : LONG_MAX;
+}
+
+/** @brief Dá um stack auxiliar vazio, reutilizando um se houver.
+ * 
+ * @param ip Apontador para o interpretador
+ * @returns Stack vazio (devolvido depois com o 'interp_GiveStack')
+ */
+Stack* interp_TakeStack(Interp* ip)
+{
+    if (ip->spareCount > 0)
+        return ip->spares[--ip->spareCount];
+    ip->stats.stacks++;
+    return stack_Create(StackInitialSize);
+}
+
+/** @brief Devolve um stack auxiliar, que é esvaziado e guardado para ser reutilizado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param stack Stack dado pelo 'interp_TakeStack'
+ */
+void interp_GiveStack(Interp* ip, Stack* stack)
+{
+    if (ip->spareCount == InterpSpareStacks)
+    {
+        stack_Dispose(stack);
+        return;
+    }
+    stack_Clear(stack);
+    ip->spares[ip->spareCount++] = stack;
+}
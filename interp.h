@@ -0,0 +1,130 @@
+/**
+ * @file Contexto de um interpretador: tudo o que um programa precisa para correr, junto num só objeto
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "code.h"
+#include "pool.h"
+#include "profile.h"
+#include "reader.h"
+#include "stack.h"
+#include "trace.h"
+
+/** Quantidade de stacks auxiliares guardados para serem reutilizados */
+#define InterpSpareStacks 8
+
+/**
+ * Canais usados pelos comandos 'l', 't' e 'p' e pelo resultado final.
+ */
+typedef struct IOT
+{
+    FILE* in;       /*!< Entrada lida pelo 'l' e pelo 't' (quando não há leitor) */
+    FILE* out;      /*!< Saída do 'p', das mensagens de erro e do stack final */
+    Reader* reader; /*!< Leitor que lê a entrada numa thread à parte (NULL para ler diretamente do 'in') */
+} IO;
+
+/**
+ * Contadores do interpretador.
+ */
+typedef struct InterpStatsT
+{
+    long instructions;  /*!< Instruções executadas */
+    long runs;          /*!< Códigos executados (o programa, os arrays e cada execução de um bloco) */
+    long stacks;        /*!< Stacks auxiliares criados (os reutilizados não contam) */
+} InterpStats;
+
+/**
+ * Interpretador. Cada um é independente, por isso podem correr vários ao mesmo tempo.
+ */
+typedef struct InterpT
+{
+    Stack* stack;       /*!< Stack onde os comandos trabalham (os arrays e os blocos auxiliares trocam-no enquanto correm) */
+    Item** vars;        /*!< Array de variáveis */
+    Code* code;         /*!< Programa compilado (NULL enquanto não há nenhum) */
+    int broken;         /*!< Fica a 1 quando um 'b' pede para sair do ciclo atual, até o ciclo o ver */
+    IO io;              /*!< Canais de entrada e saída */
+    Pool* pool;         /*!< Pool usada pelos maps e filters grandes (NULL em série) */
+    Stack* spares[InterpSpareStacks];   /*!< Stacks auxiliares vazios, prontos a reutilizar */
+    int spareCount;     /*!< Quantidade de stacks em 'spares' */
+    int owner;          /*!< 1 se as variáveis pertencem a este interpretador (0 nos workers) */
+    InterpStats stats;  /*!< Contadores */
+    Profile* profile;   /*!< Profiler (NULL quando está desligado) */
+    Trace* trace;       /*!< Tracer (NULL quando está desligado), partilhado com os workers */
+    long sampleEvery;   /*!< Instruções entre cada amostra da memória (0 sem amostras) */
+    long nextSample;    /*!< Instrução em que é tirada a próxima amostra da memória (LONG_MAX sem amostras) */
+} Interp;
+
+
+/** @brief Cria um interpretador com um stack e variáveis novas.
+ * 
+ * @warning O novo interpretador é criado com o "malloc", logo tem que ser libertado depois usando a função 'interp_Dispose'.
+ * @param in Entrada do programa
+ * @param out Saída do programa
+ * @returns Novo interpretador
+ */
+Interp* interp_Create(FILE* in, FILE* out);
+
+/** @brief Liberta o interpretador, o seu stack, as variáveis, o programa, o profiler e o tracer (os canais não são fechados).
+ * 
+ * @param ip Apontador para o interpretador
+ */
+void interp_Dispose(Interp* ip);
+
+/** @brief Prepara um worker que partilha as variáveis, os canais, a pool e o tracer, mas tem o seu próprio stack.
+ * 
+ * Usado pelos maps e filters, em que cada thread precisa do seu stack (e do seu profiler, se estiver ligado).
+ * 
+ * @param worker Interpretador a preparar
+ * @param parent Interpretador de onde vem o trabalho
+ */
+void interp_Fork(Interp* worker, Interp* parent);
+
+/** @brief Junta os contadores (e o profiler) de um worker aos do interpretador original e liberta o worker.
+ * 
+ * @param parent Interpretador de onde veio o trabalho
+ * @param worker Worker preparado pelo 'interp_Fork'
+ */
+void interp_Join(Interp* parent, Interp* worker);
+
+/** @brief Escreve os contadores numa linha, como pares nome=valor.
+ * 
+ * As alocações (de todo o programa) só aparecem se este foi compilado com a contagem, e os bytes
+ * vivos e o pico só com o seguimento (ver o 'allocs.h').
+ * 
+ * @param ip Apontador para o interpretador
+ * @param out Ficheiro onde se escreve
+ */
+void interp_PrintStats(Interp* ip, FILE* out);
+
+/** @brief Escreve numa linha o que está no stack atual e nas variáveis: items e bytes de cada tipo, espaço por usar e partilha.
+ * 
+ * Dentro de um array ou de um bloco auxiliar o stack atual é o dele (ver o 'memstats.h').
+ * 
+ * @param ip Apontador para o interpretador
+ * @param out Ficheiro onde se escreve
+ */
+void interp_PrintMemory(Interp* ip, FILE* out);
+
+/** @brief Liga as amostras da memória, escritas na 'stderr' com o 'interp_PrintMemory' durante a execução.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param every Instruções entre cada amostra (0 para desligar)
+ */
+void interp_SampleMemory(Interp* ip, long every);
+
+/** @brief Dá um stack auxiliar vazio, reutilizando um se houver.
+ * 
+ * @param ip Apontador para o interpretador
+ * @returns Stack vazio (devolvido depois com o 'interp_GiveStack')
+ */
+Stack* interp_TakeStack(Interp* ip);
+
+/** @brief Devolve um stack auxiliar, que é esvaziado e guardado para ser reutilizado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param stack Stack dado pelo 'interp_TakeStack'
+ */
+void interp_GiveStack(Interp* ip, Stack* stack);
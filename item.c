@@ -6,11 +6,25 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocs.h"
+#include "code.h"
 #include "item.h"
 #include "utils.h"
 
 // Funções auxiliares
 
+/** @brief Função auxiliar que dá o texto de uma string ou bloco.
+ * 
+ * @param item Apontador para o item
+ * @returns Texto
+ */
+char* item_p_Text(Item* item)
+{
+    if (item->type == TBlock)
+        return ((Block*)item->pointer)->text;
+    return (char*)item->pointer;
+}
+
 /** @brief Função auxiliar para converter uma lista para uma string.
  * 
  * @param list Apontador para a lista
@@ -47,21 +61,85 @@ int item_p_ToString(Item* item, char* buf, int offset)
     else if (item->type == TString)
         offset += sprintf(buf + offset, "%s", (char*)item->pointer);
     else if (item->type == TBlock)
-        offset += sprintf(buf + offset, "{%s}", (char*)item->pointer);
+        offset += sprintf(buf + offset, "{%s}", item_p_Text(item));
+    else if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        for (long i = 0; i < repeat->count; i++)
+            offset += item_p_ToString(repeat->source, buf, offset);
+    }
     else offset += list_p_ToString((List*)item->pointer, buf, offset);
     buf[offset] = '\0';
     return offset - initial;
 }
 
-/** @brief Imprime o item na consola.
- *
+/** @brief Função auxiliar que calcula o tamanho do texto de um item.
+ * 
  * @param item Apontador para o item
+ * @returns Quantidade de carateres que o 'item_p_ToString' vai escrever
  */
-void item_Print(Item* item)
+int item_p_TextSize(Item* item)
 {
-    char* string = i_ToString(item);
-    printf("%s", string);
-    free(string);
+    if (item->type == TLong)
+        return snprintf(NULL, 0, "%ld", *(long*)item->pointer);
+    if (item->type == TDouble)
+        return snprintf(NULL, 0, "%lg", *(double*)item->pointer);
+    if (item->type == TChar)
+        return 1;
+    if (item->type == TString)
+        return strlen((char*)item->pointer);
+    if (item->type == TBlock)
+        return item->size + 2;
+    if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        return item_p_TextSize(repeat->source) * repeat->count;
+    }
+    List* list = (List*)item->pointer;
+    int size = 0;
+    for (int i = 0; i < list->count; i++)
+        size += (list->array[i] != NULL) ? item_p_TextSize(list->array[i]) : 1;
+    return size;
+}
+
+/** @brief Imprime o item num ficheiro.
+ * 
+ * O item é escrito diretamente, sem ser convertido para uma string primeiro,
+ * e as vistas são impressas sem serem materializadas.
+ * 
+ * @param item Apontador para o item
+ * @param out Ficheiro onde se escreve (a 'stdout' ou a saída de um programa)
+ */
+void item_Print(Item* item, FILE* out)
+{
+    if (item->type == TLong)
+        fprintf(out, "%ld", *(long*)item->pointer);
+    else if (item->type == TDouble)
+        fprintf(out, "%lg", *(double*)item->pointer);
+    else if (item->type == TChar)
+    {
+        // O '\0' não é escrito (tal como acontece ao ser convertido para string)
+        if (*(char*)item->pointer != '\0')
+            putc(*(char*)item->pointer, out);
+    }
+    else if (item->type == TString)
+        fputs((char*)item->pointer, out);
+    else if (item->type == TBlock)
+        fprintf(out, "{%s}", item_p_Text(item));
+    else if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        for (long i = 0; i < repeat->count; i++)
+            item_Print(repeat->source, out);
+    }
+    else
+    {
+        List* list = (List*)item->pointer;
+        for (int i = 0; i < list->count; i++)
+            if (list->array[i] != NULL)
+                item_Print(list->array[i], out);
+            else putc('_', out);
+    }
 }
 
 
@@ -81,6 +159,9 @@ Item* icreate_Long(long value)
     item->size = sizeof(long);
     item->pointer = buffer;
     item->type = TLong;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TLong);
     return item;
 }
 
@@ -98,6 +179,9 @@ Item* icreate_Double(double value)
     item->size = sizeof(double);
     item->pointer = buffer;
     item->type = TDouble;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TDouble);
     return item;
 }
 
@@ -115,6 +199,9 @@ Item* icreate_Char(char value)
     item->size = sizeof(char);
     item->pointer = buffer;
     item->type = TChar;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TChar);
     return item;
 }
 
@@ -130,6 +217,9 @@ Item* icreate_String(char* value, int size)
     item->size = sizeof(char) * size;
     item->pointer = value;
     item->type = TString;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TString);
     return item;
 }
 
@@ -145,6 +235,9 @@ Item* icreate_List()
     item->size = sizeof(List);
     item->pointer = list;
     item->type = TList;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TList);
     return item;
 }
 
@@ -160,6 +253,9 @@ Item* icreate_FromList(List* list)
     item->size = sizeof(List);
     item->pointer = list;
     item->type = TList;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TList);
     return item;
 }
 
@@ -169,13 +265,41 @@ Item* icreate_FromList(List* list)
  * @param value Valor a guardar no item
  * @returns Item criado
  */
-Item* icreate_Block(char* value, int size)
+Item* icreate_Block(char* text, int size, Code* code)
 {
+    Block* block = malloc(sizeof(Block));
+    block->text = text;
+    block->code = code;
+    block->refs = 1;
     Item* item = malloc(sizeof(Item));
-    // Precisa-se do +1 por causa do '\\0' no final
-    item->size = sizeof(char) * (size + 1);
-    item->pointer = value;
+    item->size = size;
+    item->pointer = block;
     item->type = TBlock;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TBlock);
+    return item;
+}
+
+/** @brief Cria um item com uma vista de uma string ou lista repetida.
+ * 
+ * @warning O novo item é criado com o "malloc", logo tem que ser libertado depois usando a função 'item_Dispose'.
+ * @param source String ou lista a repetir (passa a pertencer à vista)
+ * @param count Quantidade de repetições
+ * @returns Item criado
+ */
+Item* icreate_Repeat(Item* source, long count)
+{
+    Repeat* repeat = malloc(sizeof(Repeat));
+    repeat->source = source;
+    repeat->count = count;
+    Item* item = malloc(sizeof(Item));
+    item->size = sizeof(Repeat);
+    item->pointer = repeat;
+    item->type = TRepeat;
+    item->capacityLog = 0;
+    item->hash = 0;
+    allocs_ItemCreated(TRepeat);
     return item;
 }
 
@@ -246,11 +370,24 @@ char i_ToChar(Item* item)
  */
 char* i_ToString(Item* item)
 {
-    char* buffer = calloc(DefaultStringBufferSize, sizeof(char));
-    int size = item_p_ToString(item, buffer, 0);
-    char* s = utils_Substring(buffer, size);
-    free(buffer);
-    return s;
+    // O tamanho é calculado antes, para o buffer nunca ser pequeno demais
+    char* buffer = calloc(item_p_TextSize(item) + 1, sizeof(char));
+    item_p_ToString(item, buffer, 0);
+    return buffer;
+}
+
+/** @brief Verifica se o item é verdadeiro (arrays não vazios, blocos, e números diferentes de 0)
+ * 
+ * @param item Apontador para o item
+ * @returns 1 ou 0
+ */
+int item_IsTrue(Item* item)
+{
+    if (item->type == TString || item->type == TList || item->type == TRepeat)
+        return item_Length(item) != 0;
+    if (item->type == TBlock)
+        return 1;
+    return i_ToLong(item) != 0;
 }
 
 /** @brief Pega no conteudo do item e converte-o para uma lista.
@@ -295,17 +432,35 @@ int item_IsType(Item* item, int mask)
 Item* item_Copy(Item* item)
 {
     Item* new = malloc(sizeof(Item));
+    allocs_ItemCreated(item->type);
     new->type = item->type;
+    new->capacityLog = 0;
     new->size = item->size;
-    if (item->type != TList)
+    new->hash = item->hash;
+    if (item->type == TList)
+        new->pointer = list_Copy(item->pointer);
+    else if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        Repeat* copy = malloc(sizeof(Repeat));
+        copy->source = item_Copy(repeat->source);
+        copy->count = repeat->count;
+        new->pointer = copy;
+    }
+    else if (item->type == TBlock)
+    {
+        // Os blocos são imutáveis, então a cópia partilha o texto e o código compilado
+        // (a contagem é atómica porque as cópias podem ser feitas em threads diferentes)
+        __atomic_add_fetch(&((Block*)item->pointer)->refs, 1, __ATOMIC_RELAXED);
+        new->pointer = item->pointer;
+    }
+    else
     {
         int size = (item->type == TString) ? item->size + 1 : item->size;
         void* buffer = malloc(size);
         memcpy(buffer, item->pointer, size);
         new->pointer = buffer;
-        return new;
     }
-    new->pointer = list_Copy(item->pointer);
     return new;
 }
 
@@ -315,18 +470,194 @@ Item* item_Copy(Item* item)
  */
 void item_Dispose(Item* item)
 {
-    if (item->type != TList)
+    allocs_ItemDisposed(item->type);
+    if (item->type == TList)
+        list_Dispose(item->pointer);
+    else if (item->type == TRepeat)
+    {
+        item_Dispose(((Repeat*)item->pointer)->source);
         free(item->pointer);
-    else list_Dispose(item->pointer);
+    }
+    else if (item->type == TBlock)
+    {
+        Block* block = (Block*)item->pointer;
+        if (__atomic_sub_fetch(&block->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            free(block->text);
+            code_Dispose(block->code);
+            free(block);
+        }
+    }
+    else free(item->pointer);
     free(item);
 }
 
+/** @brief Materializa uma vista (o item passa a ser a string ou lista que a vista representa).
+ * 
+ * @param item Apontador para o item
+ * @returns O mesmo item
+ */
+Item* item_Force(Item* item)
+{
+    if (item->type != TRepeat)
+        return item;
+    Repeat* repeat = (Repeat*)item->pointer;
+    Item* source = repeat->source;
+    allocs_ItemDisposed(TRepeat);
+    allocs_ItemCreated(source->type);
+    if (source->type == TString)
+    {
+        item->pointer = utils_RepeatString((char*)source->pointer, source->size, repeat->count);
+        item->size = source->size * repeat->count;
+        item->type = TString;
+        item->capacityLog = 0;
+        item_Dispose(source);
+    }
+    else
+    {
+        List* l = (List*)source->pointer;
+        List* new = list_Create(l->count * repeat->count);
+        for (long i = 0; i + 1 < repeat->count; i++)
+            list_AddCopyRange(new, l);
+        // A ultima repetição fica com os items originais
+        if (repeat->count > 0)
+        {
+            list_AddRange(new, l);
+            list_Free(l); item_Free(source);
+        }
+        else item_Dispose(source);
+        item->pointer = new;
+        item->size = sizeof(List);
+        item->type = TList;
+        item->capacityLog = 0;
+    }
+    free(repeat);
+    item->hash = 0;
+    return item;
+}
+
+/** @brief Dá a capacidade do buffer de uma string (os bytes alocados, incluindo o do '\0').
+ * 
+ * @param item Apontador para a string
+ * @returns Quantidade de bytes
+ */
+long item_StringCapacity(Item* item)
+{ return item->capacityLog ? 1L << item->capacityLog : item->size + 1L; }
+
+/** @brief Garante que o buffer de uma string tem espaço para size chars e o '\0', duplicando-o quando não tem.
+ * 
+ * A capacidade fica guardada no item ('capacityLog'), por isso só pode ser usada em strings cujo buffer é só delas
+ * e foi alocado com o "malloc" (o 'icreate_String' e o 'item_Copy' dão sempre um buffer assim).
+ * 
+ * @param item Apontador para a string
+ * @param size Tamanho que a string vai ter
+ */
+void item_ReserveString(Item* item, int size)
+{
+    if (item_StringCapacity(item) > size)
+        return;
+    int log = (item->capacityLog > 4) ? item->capacityLog : 4;
+    while ((1L << log) <= size)
+        log++;
+    item->pointer = realloc(item->pointer, 1L << log);
+    item->capacityLog = log;
+}
+
+/** @brief Calcula a quantidade de elementos de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @returns Quantidade de elementos (0 se o item não for uma string, lista ou vista)
+ */
+long item_Length(Item* item)
+{
+    if (item->type == TString)
+        return item->size;
+    if (item->type == TList)
+        return ((List*)item->pointer)->count;
+    if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        return item_Length(repeat->source) * repeat->count;
+    }
+    return 0;
+}
+
+/** @brief Cria uma cópia de um elemento de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @param i Indice do elemento (tem que estar dentro do tamanho)
+ * @returns Cópia do elemento (os elementos de strings são chars)
+ */
+Item* item_At(Item* item, long i)
+{
+    if (item->type == TRepeat)
+    {
+        Item* source = ((Repeat*)item->pointer)->source;
+        return item_At(source, i % item_Length(source));
+    }
+    if (item->type == TString)
+        return icreate_Char(((char*)item->pointer)[i]);
+    return item_Copy(((List*)item->pointer)->array[i]);
+}
+
+/** @brief Cria uma string ou lista com uma parte de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @param start Indice do inicio
+ * @param n Quantidade de elementos (tem que estar dentro do tamanho)
+ * @returns Nova string ou lista
+ */
+Item* item_Slice(Item* item, long start, long n)
+{
+    Item* source = (item->type == TRepeat) ? ((Repeat*)item->pointer)->source : item;
+    long length = item_Length(source);
+    if (source->type == TString)
+    {
+        char* s = calloc(n + 1, sizeof(char));
+        long done = 0;
+        // Copia pedaços contiguos da string original, voltando ao inicio quando esta acaba
+        while (done < n)
+        {
+            long pos = (start + done) % length;
+            long chunk = (length - pos < n - done) ? length - pos : n - done;
+            memcpy(s + done, (char*)source->pointer + pos, chunk);
+            done += chunk;
+        }
+        return icreate_String(s, n);
+    }
+    List* l = (List*)source->pointer;
+    List* new = list_Create(n);
+    for (long i = 0; i < n; i++)
+        list_Add(new, item_Copy(l->array[(start + i) % length]));
+    return icreate_FromList(new);
+}
+
 /** @brief Liberta a memória ocupada pelo item (apenas o struct).
  * 
  * @param item Item
  */
 void item_Free(Item* item)
-{  free(item); }
+{
+    allocs_ItemDisposed(item->type);
+    free(item);
+}
+
+/** @brief Função auxiliar que compara o texto de duas strings ou blocos.
+ * 
+ * O tamanho e o hash (se os dois já estiverem calculados) são comparados antes do texto.
+ * 
+ * @param itemA Item 
+ * @param itemB Item 
+ * @returns 1 ou 0
+ */
+int item_p_TextEquals(Item* itemA, Item* itemB)
+{
+    if (itemA->size != itemB->size)
+        return 0;
+    if (itemA->hash != 0 && itemB->hash != 0 && itemA->hash != itemB->hash)
+        return 0;
+    return utils_StringEqualsN(item_p_Text(itemA), itemA->size, item_p_Text(itemB), itemB->size);
+}
 
 /** @brief Verifica se dois items sao iguais.
  * 
@@ -336,22 +667,101 @@ void item_Free(Item* item)
  */
 int item_Equals(Item* itemA, Item* itemB)
 {
-    if (item_IsType(itemA, IT_Num2) && item_IsType(itemB, IT_Num2) && !(itemA->type == itemB->type && itemA->type == TString))
-    {
-        double a = i_ToDouble(itemA), b = i_ToDouble(itemB);
-        return utils_DoubleEquals(a, b);
-    }
-    if (itemA->type == itemB->type && (itemA->type == TString || itemA->type == TBlock))
+    ItemType tA = itemA->type, tB = itemB->type;
+    if (tA == tB && tA == TLong)
+        return *(long*)itemA->pointer == *(long*)itemB->pointer;
+    if (tA == tB && tA == TChar)
+        return *(char*)itemA->pointer == *(char*)itemB->pointer;
+    // Números de tipos diferentes não precisam de passar pelo 'sscanf'
+    if (item_IsType(itemA, IT_Num) && item_IsType(itemB, IT_Num))
+        return utils_DoubleEquals(i_ToDouble(itemA), i_ToDouble(itemB));
+    if (tA == tB && (tA == TString || tA == TBlock))
+        return item_p_TextEquals(itemA, itemB);
+    if (tA == tB && tA == TList)
+        return list_Equals((List*)itemA->pointer, (List*)itemB->pointer);
+    // Uma string e um número
+    if (item_IsType(itemA, IT_Num2) && item_IsType(itemB, IT_Num2))
+        return utils_DoubleEquals(i_ToDouble(itemA), i_ToDouble(itemB));
+    return 0;
+}
+
+/** @brief Função auxiliar que dá a ordem dos grupos de tipos usada no 'item_Compare'.
+ * 
+ * @param item Item 
+ * @returns 0 para números e strings, 1 para listas e 2 para blocos
+ */
+int item_p_CompareRank(Item* item)
+{
+    if (item_IsType(item, IT_Num2))
+        return 0;
+    return (item->type == TList) ? 1 : 2;
+}
+
+/** @brief Compara dois items.
+ * 
+ * Strings e números são comparados como no '<' (strings com strings pelo texto, o resto pelo valor).
+ * Depois destes vêm as listas (comparadas elemento a elemento) e por fim os blocos.
+ * 
+ * @param itemA Item 
+ * @param itemB Item 
+ * @returns -1, 0 ou 1
+ */
+int item_Compare(Item* itemA, Item* itemB)
+{
+    int rA = item_p_CompareRank(itemA), rB = item_p_CompareRank(itemB);
+    if (rA != rB)
+        return (rA < rB) ? -1 : 1;
+    ItemType tA = itemA->type, tB = itemB->type;
+    if (tA == tB && tA == TLong)
     {
-        char* a = (char*)itemA->pointer, *b = (char*)itemB->pointer;
-        return utils_StringEquals(a, b);
+        long a = *(long*)itemA->pointer, b = *(long*)itemB->pointer;
+        return (a > b) - (a < b);
     }
-    if (itemA->type == itemB->type && itemA->type == TList)
+    if (tA == tB && (tA == TString || tA == TBlock))
+        return utils_StringCompare(item_p_Text(itemA), item_p_Text(itemB));
+    if (tA == TList)
     {
         List* a = (List*)itemA->pointer, *b = (List*)itemB->pointer;
-        return list_Equals(a, b);
+        for (int i = 0; i < a->count && i < b->count; i++)
+        {
+            int c = item_Compare(a->array[i], b->array[i]);
+            if (c != 0)
+                return c;
+        }
+        return (a->count > b->count) - (a->count < b->count);
     }
-    return 0;
+    double a = i_ToDouble(itemA), b = i_ToDouble(itemB);
+    return (a > b) - (a < b);
+}
+
+/** @brief Calcula (ou devolve o que está em cache) o hash de um item.
+ * 
+ * Items iguais segundo o 'item_Equals' têm o mesmo hash, com uma exceção: uma string
+ * comparada com um número (que o 'item_Equals' converte para double) tem um hash diferente.
+ * 
+ * @param item Apontador para o item
+ * @returns Hash, nunca 0
+ */
+unsigned long item_Hash(Item* item)
+{
+    if (item_IsType(item, IT_Num))
+        return utils_HashDouble(i_ToDouble(item));
+    if (item->type == TList)
+        return list_Hash((List*)item->pointer);
+    if (item->hash == 0)
+        item->hash = utils_HashBytes(item_p_Text(item), item->size);
+    return item->hash;
+}
+
+/** @brief Esquece o hash em cache do item, tem que ser chamada quando o conteudo muda.
+ * 
+ * @param item Apontador para o item
+ */
+void item_InvalidateHash(Item* item)
+{
+    item->hash = 0;
+    if (item->type == TList)
+        ((List*)item->pointer)->hash = 0;
 }
 
 
@@ -367,12 +777,18 @@ void item_Swap(Item* ia, Item* ib)
     void* p = ia->pointer;
     int s = ia->size;
     ItemType t = ia->type;
+    unsigned char c = ia->capacityLog;
+    unsigned long h = ia->hash;
     ia->pointer = ib->pointer;
     ia->size = ib->size;
     ia->type = ib->type;
+    ia->capacityLog = ib->capacityLog;
+    ia->hash = ib->hash;
     ib->pointer = p;
     ib->size = s;
     ib->type = t;
+    ib->capacityLog = c;
+    ib->hash = h;
 }
 
 
@@ -394,6 +810,8 @@ List* list_Create(int initialSize)
     list->array = array;
     list->capacity = initialSize;
     list->count = 0;
+    list->hash = 0;
+    list->hasText = 0;
     return list;
 }
 
@@ -412,6 +830,8 @@ List* list_CreateRange(int n)
     list->array = array;
     list->capacity = n;
     list->count = 0;
+    list->hash = 0;
+    list->hasText = 0;
     for (int i = 0; i < n; i++)
         list_Add(list, icreate_Long(i));
     return list;
@@ -424,13 +844,10 @@ List* list_CreateRange(int n)
  */
 void list_IncreaseSize(List* list, int extraSize)
 {
-    Item** oldarray = list->array;
-    Item** newarray = calloc(list->capacity + extraSize, sizeof(Item*));
-    list->array = newarray;
-    for (int i = 0; i < list->count; i++)
-        newarray[i] = oldarray[i];
+    // O realloc evita a cópia quando pode (nas listas grandes move as páginas em vez dos items)
+    list->array = realloc(list->array, (list->capacity + extraSize) * sizeof(Item*));
+    memset(list->array + list->capacity, 0, extraSize * sizeof(Item*));
     list->capacity += extraSize;
-    free(oldarray);
 }
 
 /** @brief Cria uma cópia de uma lista.
@@ -445,6 +862,8 @@ List* list_Copy(List* list)
     for (int i = 0; i < list->count; i++)
         new->array[i] = item_Copy(list->array[i]);
     new->count = list->count;
+    new->hash = list->hash;
+    new->hasText = list->hasText;
     return new;
 }
 
@@ -481,6 +900,10 @@ int list_Equals(List* listA, List* listB)
 {
     if (listA->count != listB->count)
         return 0;
+    // Com strings, uma string pode ser igual a um número com hash diferente
+    if (listA->hash != 0 && listB->hash != 0 && !listA->hasText && !listB->hasText &&
+        listA->hash != listB->hash)
+        return 0;
     for (int i = 0; i < listA->count; i++)
         if (!item_Equals(listA->array[i], listB->array[i]))
             return 0;
@@ -488,7 +911,33 @@ int list_Equals(List* listA, List* listB)
 }
 
 
+/** @brief Calcula (ou devolve o que está em cache) o hash de uma lista.
+ * 
+ * @param list Lista
+ * @returns Hash, nunca 0
+ */
+unsigned long list_Hash(List* list)
+{
+    if (list->hash != 0)
+        return list->hash;
+    unsigned long hash = utils_HashMix(list->count);
+    int hasText = 0;
+    for (int i = 0; i < list->count; i++)
+    {
+        Item* item = list->array[i];
+        hash = utils_HashMix(hash ^ item_Hash(item));
+        if (item->type == TString || (item->type == TList && ((List*)item->pointer)->hasText))
+            hasText = 1;
+    }
+    list->hasText = hasText;
+    list->hash = hash;
+    return hash;
+}
+
+
 /** @brief Verifica se a lista tem espaço para N elementos extra, e aumenta o tamanho se esta não tiver.
+ * 
+ * A capacidade pelo menos duplica, para que adicionar N items um a um custe O(N) no total.
  * 
  * @param list Apontador para a lista
  * @param n Tamanho a verificar
@@ -496,7 +945,7 @@ int list_Equals(List* listA, List* listB)
 void list_p_AssureSizeN(List* list, int n)
 {
     if (list->count + n > list->capacity)
-        list_IncreaseSize(list, n + ListResizeSize);
+        list_IncreaseSize(list, (list->capacity > n + ListResizeSize) ? list->capacity : n + ListResizeSize);
 }
 /** @brief Verifica se a lista tem espaço para um elemento extra, e aumenta o tamanho se esta não tiver.
  * 
@@ -516,6 +965,7 @@ void list_Add(List* list, Item* item)
     list_p_AssureSize(list);
     list->array[list->count] = item;
     list->count += 1;
+    list->hash = 0;
 }
 
 /** @brief Adiciona um item a uma lista.
@@ -550,6 +1000,7 @@ void list_AddRange(List* list, List* range)
     for (int i = 0; i < range->count; i++)
         array[offset + i] = range->array[i];
     list->count += range->count;
+    list->hash = 0;
 }
 
 /** @brief Adiciona uma lista a uma lista, copiando os valores.
@@ -565,6 +1016,7 @@ void list_AddCopyRange(List* list, List* range)
     for (int i = 0; i < range->count; i++)
         array[offset + i] = item_Copy(range->array[i]);
     list->count += range->count;
+    list->hash = 0;
 }
 
 
@@ -592,6 +1044,7 @@ void list_ShiftLeftN(List* list, int index, int n)
     for (int i = 0; i < n; i++)
         array[list->count - n + i] = NULL;
     list->count -= n;
+    list->hash = 0;
 }
 
 /** @brief Desloca a lista, a partir de um indice, para a direita.
@@ -619,6 +1072,7 @@ void list_ShiftRightN(List* list, int index, int n)
     for (int i = index; i < n; i++)
         array[i] = NULL;
     list->count += n;
+    list->hash = 0;
 }
 
 
@@ -632,6 +1086,7 @@ Item* list_Remove(List* list)
     if (list->count <= 0)
         return NULL;
     list->count -= 1;
+    list->hash = 0;
     Item* item = list->array[list->count];
     list->array[list->count] = NULL;
     return item;
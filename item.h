@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <stdio.h>
+
 /** Tamanho inicial de uma lista */
 #define ListInitialSize 25
-/** Tamanho extra adicionado a uma lista quando esta precisa de ser expandida */
+/** Tamanho extra mínimo adicionado a uma lista quando esta precisa de ser expandida (normalmente duplica) */
 #define ListResizeSize 25
 
 /**
@@ -19,7 +21,8 @@ typedef enum ItemValueType
     TChar   = 4,    /*!< Chars são números inteiros que representão caracteres */
     TString = 8,    /*!< Strings são arrays de chars */
     TList   = 16,   /*!< Lista é um tipo criado por nós que guarda qualquer outro tipo neste enum */
-    TBlock  = 32,   /*!< Block é apenas uma string, mas tem que ser diferenciada para saber se é executável ou não */
+    TBlock  = 32,   /*!< Block é um pedaço de código executável, guardado como texto e já compilado */
+    TRepeat = 64,   /*!< Vista preguiçosa de uma string ou lista repetida (só existe no stack e nas variáveis) */
 } ItemType;
 
 
@@ -41,8 +44,10 @@ typedef enum ItemValueType
 typedef struct ItemContainer
 {
     void* pointer;  /*!< Apontador para o pedaço de memória onde está guardado o tipo */
-    ItemType type;  /*!< Tipo do que está guardado no apontador */
+    unsigned char type;         /*!< Tipo do que está guardado no apontador (um ItemType, num byte para o Item ficar com 24) */
+    unsigned char capacityLog;  /*!< Nas strings, o buffer tem 2^capacityLog bytes (0 se tem só size + 1), ver o 'item_StringCapacity' */
     int size;       /*!< Tamanho do item que está guardado (util para blocos e strings) */
+    unsigned long hash; /*!< Hash em cache das strings e blocos (0 se ainda não foi calculado) */
 } Item;
 
 /**
@@ -53,9 +58,31 @@ typedef struct ItemList
     Item** array;   /*!< Apontador para array de items */
     int capacity;   /*!< Quantidade de items que a lista pode guardar */
     int count;      /*!< Quantidade de items que a lista tem */
+    unsigned long hash; /*!< Hash em cache (0 se ainda não foi calculado ou se a lista mudou) */
+    int hasText;    /*!< 1 se a lista ou uma sublista tiver strings (só é válido com o hash calculado) */
 } List;
 
 
+/**
+ * Conteudo de um bloco. É partilhado por todas as cópias do item, para o código ser compilado apenas uma vez.
+ */
+typedef struct ItemBlock
+{
+    char* text;         /*!< Texto do bloco, sem as chavetas */
+    struct CodeT* code; /*!< Código compilado do bloco */
+    int refs;           /*!< Quantidade de items que partilham este bloco (alterada de forma atómica) */
+} Block;
+
+/**
+ * Vista de uma string ou lista repetida várias vezes, que só é materializada quando é preciso
+ */
+typedef struct ItemRepeat
+{
+    Item* source;   /*!< String ou lista repetida (pertence à vista) */
+    long count;     /*!< Quantidade de repetições */
+} Repeat;
+
+
 // Criar o item
 
 /** @brief Cria um item com um long.
@@ -108,10 +135,21 @@ Item* icreate_FromList(List* list);
 /** @brief Cria um item com um bloco.
  * 
  * @warning O novo item é criado com o "malloc", logo tem que ser libertado depois usando a função 'item_Dispose'.
- * @param value Valor a guardar no item
+ * @param text Texto do bloco, sem as chavetas (passa a pertencer ao bloco)
+ * @param size Tamanho do texto
+ * @param code Código compilado do bloco (passa a pertencer ao bloco)
+ * @returns Item criado
+ */
+Item* icreate_Block(char* text, int size, struct CodeT* code);
+
+/** @brief Cria um item com uma vista de uma string ou lista repetida.
+ * 
+ * @warning O novo item é criado com o "malloc", logo tem que ser libertado depois usando a função 'item_Dispose'.
+ * @param source String ou lista a repetir (passa a pertencer à vista)
+ * @param count Quantidade de repetições
  * @returns Item criado
  */
-Item* icreate_Block(char* value, int size);
+Item* icreate_Repeat(Item* source, long count);
 
 
 
@@ -145,6 +183,13 @@ char i_ToChar(Item* item);
  */
 char* i_ToString(Item* item);
 
+/** @brief Verifica se o item é verdadeiro (arrays não vazios, blocos, e números diferentes de 0)
+ * 
+ * @param item Apontador para o item
+ * @returns 1 ou 0
+ */
+int item_IsTrue(Item* item);
+
 /** @brief Pega no conteudo do item e converte-o para uma lista
  * 
  * @param item Apontador para o item
@@ -173,11 +218,19 @@ int list_p_ToString(List* list, char* buf, int offset);
  */
 int item_p_ToString(Item* item, char* buf, int offset);
 
-/** @brief Imprime o item na consola.
- *
+/** @brief Função auxiliar que calcula o tamanho do texto de um item.
+ * 
+ * @param item Apontador para o item
+ * @returns Quantidade de carateres que o 'item_p_ToString' vai escrever
+ */
+int item_p_TextSize(Item* item);
+
+/** @brief Imprime o item num ficheiro.
+ * 
  * @param item Apontador para o item
+ * @param out Ficheiro onde se escreve (a 'stdout' ou a saída de um programa)
  */
-void item_Print(Item* item);
+void item_Print(Item* item, FILE* out);
 
 
 
@@ -191,6 +244,54 @@ void item_Print(Item* item);
  */
 int item_IsType(Item* item, int mask);
 
+/** @brief Materializa uma vista (o item passa a ser a string ou lista que a vista representa).
+ * 
+ * @param item Apontador para o item
+ * @returns O mesmo item
+ */
+Item* item_Force(Item* item);
+
+/** @brief Dá a capacidade do buffer de uma string (os bytes alocados, incluindo o do '\0').
+ * 
+ * @param item Apontador para a string
+ * @returns Quantidade de bytes
+ */
+long item_StringCapacity(Item* item);
+
+/** @brief Garante que o buffer de uma string tem espaço para size chars e o '\0', duplicando-o quando não tem.
+ * 
+ * A capacidade fica guardada no item ('capacityLog'), por isso só pode ser usada em strings cujo buffer é só delas
+ * e foi alocado com o "malloc" (o 'icreate_String' e o 'item_Copy' dão sempre um buffer assim).
+ * 
+ * @param item Apontador para a string
+ * @param size Tamanho que a string vai ter
+ */
+void item_ReserveString(Item* item, int size);
+
+/** @brief Calcula a quantidade de elementos de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @returns Quantidade de elementos (0 se o item não for uma string, lista ou vista)
+ */
+long item_Length(Item* item);
+
+/** @brief Cria uma cópia de um elemento de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @param i Indice do elemento (tem que estar dentro do tamanho)
+ * @returns Cópia do elemento (os elementos de strings são chars)
+ */
+Item* item_At(Item* item, long i);
+
+/** @brief Cria uma string ou lista com uma parte de uma string, lista ou vista, sem a materializar.
+ * 
+ * @param item Apontador para o item
+ * @param start Indice do inicio
+ * @param n Quantidade de elementos (tem que estar dentro do tamanho)
+ * @returns Nova string ou lista
+ */
+Item* item_Slice(Item* item, long start, long n);
+
 /** @brief Cria uma cópia do item.
  * 
  * @param item Item
@@ -218,6 +319,33 @@ void item_Free(Item* item);
  */
 int item_Equals(Item* itemA, Item* itemB);
 
+/** @brief Compara dois items.
+ * 
+ * Strings e números são comparados como no '<' (strings com strings pelo texto, o resto pelo valor).
+ * Depois destes vêm as listas (comparadas elemento a elemento) e por fim os blocos.
+ * 
+ * @param itemA Item 
+ * @param itemB Item 
+ * @returns -1, 0 ou 1
+ */
+int item_Compare(Item* itemA, Item* itemB);
+
+/** @brief Calcula (ou devolve o que está em cache) o hash de um item.
+ * 
+ * Items iguais segundo o 'item_Equals' têm o mesmo hash, com uma exceção: uma string
+ * comparada com um número (que o 'item_Equals' converte para double) tem um hash diferente.
+ * 
+ * @param item Apontador para o item
+ * @returns Hash, nunca 0
+ */
+unsigned long item_Hash(Item* item);
+
+/** @brief Esquece o hash em cache do item, tem que ser chamada quando o conteudo muda.
+ * 
+ * @param item Apontador para o item
+ */
+void item_InvalidateHash(Item* item);
+
 /** @brief Troca o conteudo de dois items.
  * 
  * @param ia Primeiro item
@@ -281,6 +409,14 @@ void list_Free(List* list);
 int list_Equals(List* listA, List* listB);
 
 
+/** @brief Calcula (ou devolve o que está em cache) o hash de uma lista.
+ * 
+ * @param list Lista
+ * @returns Hash, nunca 0
+ */
+unsigned long list_Hash(List* list);
+
+
 /** @brief Adiciona um item a uma lista.
  * 
  * @param list Lista
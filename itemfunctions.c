@@ -31,6 +31,8 @@ int ifunc_ConvertToLong(Item* item)
     item->size = sizeof(long);
     item->pointer = buffer;
     item->type = TLong;
+    item->capacityLog = 0;
+    item->hash = 0;
     return 1;
 }
 
@@ -52,6 +54,8 @@ int ifunc_ConvertToDouble(Item* item)
     item->size = sizeof(double);
     item->pointer = buffer;
     item->type = TDouble;
+    item->capacityLog = 0;
+    item->hash = 0;
     return 1;
 }
 
@@ -73,6 +77,8 @@ int ifunc_ConvertToChar(Item* item)
     item->size = sizeof(char);
     item->pointer = buffer;
     item->type = TChar;
+    item->capacityLog = 0;
+    item->hash = 0;
     return 1;
 }
 
@@ -93,6 +99,8 @@ int ifunc_ConvertToString(Item* item)
     item->size = strlen(buffer) * sizeof(char);
     item->pointer = buffer;
     item->type = TString;
+    item->capacityLog = 0;
+    item->hash = 0;
     return 1;
 }
 
@@ -109,7 +117,7 @@ int ifunc_ConvertToList(Item* item)
     if (item->type == TList)
         return 1;
     List* list;
-    if (item->type != TString)
+    if (item->type == TString)
     {
         list = list_FromString((char*)item->pointer, item->size);
         free(item->pointer);
@@ -123,6 +131,8 @@ int ifunc_ConvertToList(Item* item)
     item->pointer = list;
     item->size = sizeof(List);
     item->type = TList;
+    item->capacityLog = 0;
+    item->hash = 0;
     return 1;
 }
 
@@ -0,0 +1,190 @@
+/**
+ * @file Conjunto de items (hash set com endereçamento aberto), usa a igualdade do 'item_Equals'
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "itemset.h"
+#include "utils.h"
+
+
+/** @brief Calcula o hash de um item como o 'item_Hash', mas com as strings (e as de dentro das listas) a terem o hash
+ * do número em que se convertem, como o 'item_Equals' as compara com números.
+ * 
+ * @param item Apontador para o item
+ * @returns Hash, nunca 0
+ */
+unsigned long set_p_NumericHash(Item* item)
+{
+    if (item_IsType(item, IT_Num2))
+        return utils_HashDouble(i_ToDouble(item));
+    if (item->type != TList)
+        return item_Hash(item);
+    // Igual ao 'list_Hash', sem cache (a cache guarda o hash normal)
+    List* list = (List*)item->pointer;
+    unsigned long hash = utils_HashMix(list->count);
+    for (int i = 0; i < list->count; i++)
+        hash = utils_HashMix(hash ^ set_p_NumericHash(list->array[i]));
+    return hash ? hash : 1;
+}
+
+/** @brief Calcula o hash de um item no conjunto.
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @returns Hash, nunca 0
+ */
+unsigned long set_p_Hash(ItemSet* set, Item* item)
+{ return set->numeric ? set_p_NumericHash(item) : item_Hash(item); }
+
+/** @brief Junta os tipos dos items de uma lista e das sublistas.
+ * 
+ * @param list Apontador para a lista
+ * @returns Bits dos tipos encontrados
+ */
+int set_p_Types(List* list)
+{
+    int types = 0;
+    for (int i = 0; i < list->count; i++)
+    {
+        Item* item = list->array[i];
+        types |= (item->type == TList) ? set_p_Types((List*)item->pointer) : (int)item->type;
+    }
+    return types;
+}
+
+/** @brief Procura o espaço de um item (o espaço com um item igual, ou o primeiro livre).
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @param hash Hash do item
+ * @returns Indice do espaço
+ */
+int set_p_Find(ItemSet* set, Item* item, unsigned long hash)
+{
+    int mask = set->capacity - 1;
+    int i = (int)(hash & mask);
+    while (set->slots[i] != NULL)
+    {
+        if (set->hashes[i] == hash && item_Equals(set->slots[i], item))
+            return i;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/** @brief Duplica a capacidade do conjunto.
+ * 
+ * @param set Apontador para o conjunto
+ */
+void set_p_Grow(ItemSet* set)
+{
+    Item** oldSlots = set->slots;
+    unsigned long* oldHashes = set->hashes;
+    int oldCapacity = set->capacity;
+    set->capacity *= 2;
+    set->slots = calloc(set->capacity, sizeof(Item*));
+    set->hashes = calloc(set->capacity, sizeof(unsigned long));
+    int mask = set->capacity - 1;
+    for (int i = 0; i < oldCapacity; i++)
+        if (oldSlots[i] != NULL)
+        {
+            int j = (int)(oldHashes[i] & mask);
+            while (set->slots[j] != NULL)
+                j = (j + 1) & mask;
+            set->slots[j] = oldSlots[i];
+            set->hashes[j] = oldHashes[i];
+        }
+    free(oldSlots);
+    free(oldHashes);
+}
+
+
+/** @brief Cria um conjunto.
+ * 
+ * @warning O novo conjunto é criado com o "malloc", logo tem que ser libertado depois usando a função 'set_Dispose'.
+ * @param expected Quantidade de items que se espera guardar
+ * @returns Novo conjunto
+ */
+ItemSet* set_Create(int expected, int numeric)
+{
+    ItemSet* set = malloc(sizeof(ItemSet));
+    // A ocupação fica abaixo de metade, para as procuras serem curtas
+    int capacity = 16;
+    while (capacity < expected * 2)
+        capacity *= 2;
+    set->slots = calloc(capacity, sizeof(Item*));
+    set->hashes = calloc(capacity, sizeof(unsigned long));
+    set->capacity = capacity;
+    set->count = 0;
+    set->numeric = numeric;
+    return set;
+}
+
+/** @brief Liberta a memória ocupada pelo conjunto (os items não são libertados).
+ * 
+ * @param set Apontador para o conjunto
+ */
+void set_Dispose(ItemSet* set)
+{
+    free(set->slots);
+    free(set->hashes);
+    free(set);
+}
+
+/** @brief Verifica se o conjunto tem um item igual.
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @returns 1 ou 0
+ */
+int set_Contains(ItemSet* set, Item* item)
+{
+    int i = set_p_Find(set, item, set_p_Hash(set, item));
+    return set->slots[i] != NULL;
+}
+
+/** @brief Adiciona um item ao conjunto, se este ainda não tiver um igual.
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @returns 1 se o item foi adicionado, 0 se já lá estava um igual
+ */
+int set_Add(ItemSet* set, Item* item)
+{
+    unsigned long hash = set_p_Hash(set, item);
+    int i = set_p_Find(set, item, hash);
+    if (set->slots[i] != NULL)
+        return 0;
+    set->slots[i] = item;
+    set->hashes[i] = hash;
+    set->count++;
+    if (set->count * 2 > set->capacity)
+        set_p_Grow(set);
+    return 1;
+}
+
+/** @brief Adiciona todos os items de uma lista ao conjunto.
+ * 
+ * @param set Apontador para o conjunto
+ * @param list Apontador para a lista
+ */
+void set_AddList(ItemSet* set, List* list)
+{
+    for (int i = 0; i < list->count; i++)
+        set_Add(set, list->array[i]);
+}
+
+/** @brief Verifica se há números (ou chars) e strings misturados em duas listas, incluindo nas sublistas.
+ * 
+ * @param a Apontador para a primeira lista
+ * @param b Apontador para a segunda lista (pode ser NULL)
+ * @returns 1 ou 0
+ */
+int set_IsMixed(List* a, List* b)
+{
+    int types = set_p_Types(a) | ((b != NULL) ? set_p_Types(b) : 0);
+    return (types & IT_Num) && (types & TString);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file Conjunto de items (hash set com endereçamento aberto), usa a igualdade do 'item_Equals'
+ */
+
+#pragma once
+
+#include "item.h"
+
+/**
+ * Conjunto de items. Os items não pertencem ao conjunto, apenas são referenciados.
+ */
+typedef struct ItemSetT
+{
+    Item** slots;           /*!< Array de apontadores para os items (NULL nos espaços livres) */
+    unsigned long* hashes;  /*!< Hash do item em cada espaço */
+    int capacity;           /*!< Quantidade de espaços (sempre uma potência de 2) */
+    int count;              /*!< Quantidade de items no conjunto */
+    int numeric;            /*!< 1 se as strings têm o hash do número em que se convertem (ver o 'set_Create') */
+} ItemSet;
+
+
+/** @brief Cria um conjunto.
+ * 
+ * O 'item_Equals' considera uma string igual a um número se esta se converter nesse número (1 e "1" são iguais),
+ * mas o 'item_Hash' dá-lhes hashes diferentes. Quando há números e strings misturados ('set_IsMixed') o conjunto
+ * tem que ser criado com 'numeric', para as strings terem o hash do seu número (mais colisões, mas iguais ao '=').
+ * 
+ * @warning O novo conjunto é criado com o "malloc", logo tem que ser libertado depois usando a função 'set_Dispose'.
+ * @param expected Quantidade de items que se espera guardar
+ * @param numeric 1 se as strings devem ter o hash do número em que se convertem
+ * @returns Novo conjunto
+ */
+ItemSet* set_Create(int expected, int numeric);
+
+/** @brief Verifica se há números (ou chars) e strings misturados em duas listas, incluindo nas sublistas.
+ * 
+ * @param a Apontador para a primeira lista
+ * @param b Apontador para a segunda lista (pode ser NULL)
+ * @returns 1 ou 0
+ */
+int set_IsMixed(List* a, List* b);
+
+/** @brief Liberta a memória ocupada pelo conjunto (os items não são libertados).
+ * 
+ * @param set Apontador para o conjunto
+ */
+void set_Dispose(ItemSet* set);
+
+/** @brief Verifica se o conjunto tem um item igual.
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @returns 1 ou 0
+ */
+int set_Contains(ItemSet* set, Item* item);
+
+/** @brief Adiciona um item ao conjunto, se este ainda não tiver um igual.
+ * 
+ * @param set Apontador para o conjunto
+ * @param item Apontador para o item
+ * @returns 1 se o item foi adicionado, 0 se já lá estava um igual
+ */
+int set_Add(ItemSet* set, Item* item);
+
+/** @brief Adiciona todos os items de uma lista ao conjunto.
+ * 
+ * @param set Apontador para o conjunto
+ * @param list Apontador para a lista
+ */
+void set_AddList(ItemSet* set, List* list);
@@ -6,29 +6,139 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "vars.h"
-#include "stack.h"
+#include "allocs.h"
+#include "counters.h"
+#include "interp.h"
 #include "utils.h"
 #include "parser.h"
+#include "pool.h"
+#include "batch.h"
+
+// Com -DBENCH o ponto de entrada é o dos benchmarks (bench.c)
+#ifndef BENCH
+
+/**
+ * Opções da linha de comandos
+ */
+typedef struct MainOptionsT
+{
+    char* batch;    /*!< Ficheiro do batch (NULL se não foi pedido) */
+    int stats;      /*!< 1 se foi pedido o '--stats' */
+    int profile;    /*!< 0 sem profiler, 1 com o '--profile', 2 com o '--profile-positions' */
+    int counters;   /*!< 1 se foi pedido o '--profile-counters' */
+    int allocs;     /*!< 1 se foi pedido o '--allocs' */
+    char* trace;    /*!< Ficheiro do trace (NULL se não foi pedido) */
+    long memstats;  /*!< Instruções entre cada amostra do '--memstats' (0 se não foi pedido) */
+} MainOptions;
+
+/** @brief Lê as opções da linha de comandos.
+ * 
+ * Opções aceites:
+ *   --threads N           Divide os maps e filters grandes (ou os trabalhos do batch) por N threads (por omissão 1, sem threads)
+ *   --batch F             Corre os trabalhos do ficheiro F em vez de ler um programa da 'stdin'
+ *   --stats               No fim escreve os contadores do interpretador na 'stderr'
+ *   --profile             No fim escreve na 'stderr' o tempo e as alocações de cada comando e família de handlers
+ *   --profile-positions   O mesmo que o '--profile', com mais uma tabela para cada posição do programa
+ *   --profile-counters    Junta ao profiler os contadores do processador (ver o 'counters.h'); liga o '--profile' se não estiver
+ *   --allocs              No fim (depois de libertar tudo) escreve o relatório das alocações na 'stderr' (ver o 'allocs.h')
+ *   --memstats N          Escreve na 'stderr' a memória do stack e das variáveis a cada N instruções e no fim (ver o 'memstats.h')
+ *   --trace F             Guarda cada instrução executada no ficheiro F, para ser convertido pelo 'trace.py' (ver o 'trace.h')
+ * 
+ * @param argc Quantidade de argumentos
+ * @param argv Argumentos
+ * @param options Out: opções lidas
+ */
+void main_p_Options(int argc, char** argv, MainOptions* options)
+{
+    memset(options, 0, sizeof(MainOptions));
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            pool_SetThreads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            options->batch = argv[++i];
+        else if (strcmp(argv[i], "--stats") == 0)
+            options->stats = 1;
+        else if (strcmp(argv[i], "--profile") == 0)
+            options->profile = 1;
+        else if (strcmp(argv[i], "--profile-positions") == 0)
+            options->profile = 2;
+        else if (strcmp(argv[i], "--profile-counters") == 0)
+            options->counters = 1;
+        else if (strcmp(argv[i], "--allocs") == 0)
+            options->allocs = 1;
+        else if (strcmp(argv[i], "--memstats") == 0 && i + 1 < argc)
+            options->memstats = atol(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            options->trace = argv[++i];
+        else fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+    }
+    if (options->counters && !options->profile)
+        options->profile = 1;
+}
 
 /**
  * Ponto de entrada do programa
  */
-int main()
+int main(int argc, char** argv)
 {
-    Item** vars = vars_CreateArray();
-    Stack* stack = stack_Create(StackInitialSize);
+    MainOptions options;
+    main_p_Options(argc, argv, &options);
+    if (options.batch != NULL)
+    {
+        int r = batch_Run(options.batch, stdout);
+        pool_SetThreads(1);
+        if (options.allocs)
+            allocs_Report(stderr);
+        return r;
+    }
+
+    // A entrada é toda lida pelo leitor, que vai adiantando o 'l' e o 't' enquanto o programa corre
+    Reader* reader = reader_Create(fileno(stdin));
+    Interp* ip = interp_Create(stdin, stdout);
+    ip->io.reader = reader;
 
-    int size; char* line = utils_GetLine(&size);
+    int size; char* line = reader_GetLine(reader, &size);
+    // Sem entrada nenhuma o programa fica vazio
+    if (line == NULL)
+    {
+        line = calloc(1, sizeof(char));
+        size = 0;
+    }
+    // As posições do profiler contam a partir do inicio do programa (depois do 'z')
+    char* program = (line[0] == 'z') ? line + 1 : line;
+    if (options.counters)
+        counters_Enable();
+    if (options.profile)
+        ip->profile = profile_Create((options.profile == 2) ? size : 0);
+    if (options.trace != NULL)
+        ip->trace = trace_Create(TraceDefaultEvents);
+    if (options.memstats > 0)
+        interp_SampleMemory(ip, options.memstats);
     if (line[0] == 'z')
-        parser_DebugProcess(vars, stack, line + 1, size);
-    else parser_Process(vars, stack, line, size);
+        parser_DebugProcess(ip, program, size);
+    else parser_Process(ip, program, size);
 
-    stack_Print(stack);
+    stack_Print(ip->stack, stdout);
     printf("\n");
+    if (options.stats)
+        interp_PrintStats(ip, stderr);
+    if (options.memstats > 0)
+        interp_PrintMemory(ip, stderr);
+    if (options.profile)
+        profile_Print(ip->profile, program, stderr);
+    if (options.counters)
+        counters_Disable();
+    if (options.trace != NULL)
+        trace_Save(ip->trace, program, options.trace);
 
-    vars_Dispose(vars);
-    stack_Dispose(stack);
+    interp_Dispose(ip);
+    free(line);
+    reader_Dispose(reader);
+    pool_SetThreads(1);
+    if (options.allocs)
+        allocs_Report(stderr);
     return 0;
 }
 
+#endif
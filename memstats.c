@@ -0,0 +1,174 @@
+/**
+ * @file Contabilidade da memória: percorre o stack e as variáveis e conta os items de cada tipo, os bytes que
+ * ocupam, o espaço por usar nas listas e quanto é partilhado
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "code.h"
+#include "memstats.h"
+
+/** Nome de cada tipo, pelo indice do bit do ItemType */
+static const char* memstats_p_typeNames[MemTypeCount] =
+{
+    "long", "double", "char", "string", "list", "block", "repeat"
+};
+
+/**
+ * Estado do percurso: os valores e os blocos encontrados (para contar cada um só uma vez)
+ */
+typedef struct MemWalkT
+{
+    MemStats* stats;    /*!< Valores contados */
+    Block** blocks;     /*!< Blocos encontrados, repetidos */
+    int blockCount;     /*!< Quantidade de blocos em 'blocks' */
+    int blockCapacity;  /*!< Capacidade de 'blocks' */
+} MemWalk;
+
+
+/** @brief Dá o tamanho de uma string ou lista (o que uma repetição repete).
+ * 
+ * @param item Apontador para o item
+ * @returns Quantidade de elementos
+ */
+long memstats_p_Length(Item* item)
+{
+    if (item->type == TList)
+        return ((List*)item->pointer)->count;
+    return (item->type == TString) ? item->size : 1;
+}
+
+/** @brief Conta um item e o que está dentro dele.
+ * 
+ * @param walk Estado do percurso
+ * @param item Apontador para o item (pode ser NULL)
+ */
+void memstats_p_Item(MemWalk* walk, Item* item)
+{
+    if (item == NULL || item->type == 0)
+        return;
+    MemStats* stats = walk->stats;
+    int t = __builtin_ctz(item->type);
+    stats->items[t]++;
+    if (item->type == TList)
+    {
+        List* list = (List*)item->pointer;
+        stats->bytes[t] += sizeof(List) + list->capacity * sizeof(Item*);
+        stats->listCount += list->count;
+        stats->listCapacity += list->capacity;
+        for (int i = 0; i < list->count; i++)
+            memstats_p_Item(walk, list->array[i]);
+    }
+    else if (item->type == TRepeat)
+    {
+        Repeat* repeat = (Repeat*)item->pointer;
+        stats->bytes[t] += sizeof(Repeat);
+        stats->repeatLength += memstats_p_Length(repeat->source) * repeat->count;
+        stats->repeatStored += memstats_p_Length(repeat->source);
+        memstats_p_Item(walk, repeat->source);
+    }
+    else if (item->type == TBlock)
+    {
+        // Os bytes dos blocos só são contados no fim, uma vez por cada bloco distinto
+        if (walk->blockCount == walk->blockCapacity)
+        {
+            walk->blockCapacity = walk->blockCapacity ? walk->blockCapacity * 2 : 16;
+            walk->blocks = realloc(walk->blocks, walk->blockCapacity * sizeof(Block*));
+        }
+        walk->blocks[walk->blockCount++] = (Block*)item->pointer;
+    }
+    else stats->bytes[t] += (item->type == TString) ? item_StringCapacity(item) : item->size;
+}
+
+/** @brief Compara dois apontadores para blocos, para o qsort.
+ * 
+ * @param a Apontador para o primeiro
+ * @param b Apontador para o segundo
+ * @returns Negativo, zero ou positivo
+ */
+int memstats_p_CompareBlocks(const void* a, const void* b)
+{
+    const Block* x = *(Block* const*)a, *y = *(Block* const*)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Conta os blocos distintos e os bytes de cada um (o texto e as instruções compiladas).
+ * 
+ * @param walk Estado do percurso
+ */
+void memstats_p_Blocks(MemWalk* walk)
+{
+    MemStats* stats = walk->stats;
+    int t = __builtin_ctz(TBlock);
+    if (walk->blockCount > 0)
+        qsort(walk->blocks, walk->blockCount, sizeof(Block*), memstats_p_CompareBlocks);
+    for (int i = 0; i < walk->blockCount; i++)
+    {
+        Block* block = walk->blocks[i];
+        if (i > 0 && walk->blocks[i - 1] == block)
+            continue;
+        stats->blocks++;
+        stats->bytes[t] += sizeof(Block) + strlen(block->text) + 1;
+        if (block->code != NULL)
+            stats->bytes[t] += sizeof(Code) + block->code->capacity * sizeof(Instruction);
+    }
+    free(walk->blocks);
+}
+
+/** @brief Conta os items de um stack e das variáveis.
+ * 
+ * @param stack Stack a percorrer
+ * @param vars Array com as 26 variáveis
+ * @param stats Out: valores contados
+ */
+void memstats_Collect(Stack* stack, Item** vars, MemStats* stats)
+{
+    MemWalk walk = { stats, NULL, 0, 0 };
+    memset(stats, 0, sizeof(MemStats));
+    stats->stackCount = stack_Count(stack);
+    stats->stackCapacity = stack->capacity;
+    for (int i = 0; i < stack_Count(stack); i++)
+        memstats_p_Item(&walk, stack->array[i]);
+    for (int i = 0; i < 26; i++)
+        memstats_p_Item(&walk, vars[i]);
+    memstats_p_Blocks(&walk);
+}
+
+/** @brief Dá o total de bytes contados: as estruturas Item e o conteudo de todos os tipos.
+ * 
+ * @param stats Valores contados
+ * @returns Quantidade de bytes
+ */
+long memstats_Bytes(MemStats* stats)
+{
+    long bytes = 0;
+    for (int t = 0; t < MemTypeCount; t++)
+        bytes += stats->items[t] * sizeof(Item) + stats->bytes[t];
+    return bytes;
+}
+
+/** @brief Escreve os valores contados na mesma linha, como pares nome=valor (começando por um espaço), e muda de linha.
+ * 
+ * @param stats Valores contados
+ * @param out Ficheiro onde se escreve
+ */
+void memstats_Print(MemStats* stats, FILE* out)
+{
+    long items = 0;
+    for (int t = 0; t < MemTypeCount; t++)
+        items += stats->items[t];
+    fprintf(out, " items=%ld bytes=%ld", items, memstats_Bytes(stats));
+    for (int t = 0; t < MemTypeCount; t++)
+        if (stats->items[t] > 0)
+            fprintf(out, " %s=%ld/%ld", memstats_p_typeNames[t], stats->items[t], stats->bytes[t]);
+    fprintf(out, " list_slack=%ld stack_slack=%ld", stats->listCapacity - stats->listCount,
+        stats->stackCapacity - stats->stackCount);
+    int t = __builtin_ctz(TBlock);
+    if (stats->blocks > 0)
+        fprintf(out, " block_sharing=%.2f", (double)stats->items[t] / stats->blocks);
+    if (stats->repeatStored > 0)
+        fprintf(out, " repeat_ratio=%.2f", (double)stats->repeatLength / stats->repeatStored);
+    fprintf(out, "\n");
+}
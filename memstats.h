@@ -0,0 +1,57 @@
+/**
+ * @file Contabilidade da memória: percorre o stack e as variáveis e conta os items de cada tipo, os bytes que
+ * ocupam, o espaço por usar nas listas e quanto é partilhado
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "item.h"
+#include "stack.h"
+
+/** Quantidade de tipos de items (um por cada bit do ItemType) */
+#define MemTypeCount 7
+
+/**
+ * Valores contados num stack e nas variáveis (os items de dentro das listas e das repetições também contam)
+ */
+typedef struct MemStatsT
+{
+    long items[MemTypeCount];   /*!< Items de cada tipo, pelo indice do bit do ItemType */
+    long bytes[MemTypeCount];   /*!< Bytes do conteudo de cada tipo, sem a estrutura Item (os blocos partilhados contam uma vez) */
+    long listCount;             /*!< Items guardados nas listas */
+    long listCapacity;          /*!< Capacidade das listas (o que sobra do 'listCount' está alocado e por usar) */
+    long stackCount;            /*!< Items no stack */
+    long stackCapacity;         /*!< Capacidade do stack */
+    long blocks;                /*!< Blocos distintos (os items de blocos partilham-nos, ver o 'item_Copy') */
+    long repeatLength;          /*!< Elementos vistos pelas repetições */
+    long repeatStored;          /*!< Elementos guardados pelas repetições (cada uma guarda só a string ou lista repetida) */
+} MemStats;
+
+
+/** @brief Conta os items de um stack e das variáveis.
+ * 
+ * @param stack Stack a percorrer
+ * @param vars Array com as 26 variáveis
+ * @param stats Out: valores contados
+ */
+void memstats_Collect(Stack* stack, Item** vars, MemStats* stats);
+
+/** @brief Dá o total de bytes contados: as estruturas Item e o conteudo de todos os tipos.
+ * 
+ * @param stats Valores contados
+ * @returns Quantidade de bytes
+ */
+long memstats_Bytes(MemStats* stats);
+
+/** @brief Escreve os valores contados na mesma linha, como pares nome=valor (começando por um espaço), e muda de linha.
+ * 
+ * Cada tipo aparece como tipo=items/bytes (só os que têm items), seguido dos lugares por usar nas listas e no
+ * stack (capacidade menos items), de quantos items há por cada bloco distinto e de quantos elementos as
+ * repetições mostram por cada um que guardam.
+ * 
+ * @param stats Valores contados
+ * @param out Ficheiro onde se escreve
+ */
+void memstats_Print(MemStats* stats, FILE* out);
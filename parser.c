@@ -5,137 +5,287 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 #include "stack.h"
 #include "utils.h"
 #include "parser.h"
+#include "vm.h"
 
-#include "handler_vars.h"
-#include "handler_math.h"
-#include "handler_array.h"
-#include "handler_stack.h"
-#include "handler_logic.h"
 
+// Linha
 
-/** @brief Esta função é um hub para todas as outras funções que resolvem a entrada
+/** Chars que podem fazer parte de um número lido pelo "%lg" (dígitos, sinais, expoentes, hexadecimais, "inf" e "nan") */
+#define LineNumberChars "0123456789+-.eEpPxXaAbBcCdDfFiInNtTyY"
+
+/** @brief Lê o número no inicio do texto, como o "%lg" do 'sscanf'.
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
- * @param cmd Char do comando
- * @param line Linha da entrada
- * @param linePos Posição na linha
- * @returns 1 se tiver sucesso
+ * O 'sscanf' mede o texto todo (com o 'strlen') antes de o ler, o que torna a leitura de
+ * uma linha inteira quadrática. Por isso só lhe é passada a parte do texto que pode ser
+ * um número (o resultado é o mesmo).
+ * 
+ * @param text Texto
+ * @param value Apontador para o valor lido
+ * @returns Quantidade de chars do número, ou 0 se o texto não começar por um número
+ */
+int line_p_ReadNumber(char* text, double* value)
+{
+    char c = text[0], small[64];
+    int offset = 0;
+    if (c == '\0' || !((c >= '0' && c <= '9') || strchr("+-.iInN", c) != NULL))
+        return 0;
+    // O "nan(...)" pode ter outros chars dentro dos parênteses, mas é raro
+    if (strncasecmp(text, "nan(", 4) == 0)
+        return (sscanf(text, "%lg%n", value, &offset) == 1) ? offset : 0;
+    size_t span = strspn(text, LineNumberChars);
+    char* window = (span < sizeof(small)) ? small : malloc(span + 1);
+    memcpy(window, text, span);
+    window[span] = '\0';
+    int r = sscanf(window, "%lg%n", value, &offset);
+    if (window != small)
+        free(window);
+    return (r == 1) ? offset : 0;
+}
+
+/** @brief Calcula quantos chars ocupa o número no inicio do texto.
+ * 
+ * @param text Texto
+ * @returns Quantidade de chars do número, ou 0 se o texto não começar por um número
  */
-int handler_Handle(Item** vars, Stack* stack, char cmd, char* line, int* linePos)
+int line_p_NumberLength(char* text)
 {
-    return hHub_Vars(vars, stack, cmd, line, linePos) || hHub_Math(stack, cmd) ||
-    hHub_Stack(stack, cmd) || hHub_Array(vars, stack, cmd, line, linePos) ||
-    hHub_Logic(stack, cmd, line, linePos);
+    double discard;
+    return line_p_ReadNumber(text, &discard);
 }
 
+/** @brief Guarda o par de um ']' ou '}' na tabela.
+ * 
+ * Procura no stack dos chars abertos o ultimo do mesmo tipo. Os que ficarem pelo caminho
+ * (abertos dentro deste e nunca fechados) acabam no mesmo sitio.
+ * 
+ * @param line Apontador para a linha
+ * @param open Stack com as posições dos chars abertos
+ * @param depth Apontador para a quantidade de chars abertos
+ * @param pos Posição do char que fecha
+ */
+void line_p_Close(Line* line, int* open, int* depth, int pos)
+{
+    char opener = (line->text[pos] == ']') ? '[' : '{';
+    int d = *depth - 1;
+    while (d >= 0 && line->text[open[d]] != opener)
+        d--;
+    if (d < 0)
+        return;
+    for (int i = d; i < *depth; i++)
+        line->match[open[i]] = pos;
+    *depth = d;
+}
 
-/** @brief Verifica se a entrada tem um número (double ou long) e guarda-o no stack
+/** @brief Cria uma linha e calcula, numa só passagem, a tabela dos pares.
  * 
- * @param stack Apontador para o stack
- * @param line Linha da entrada
+ * Os tokens são lidos da mesma forma que no 'parser_Process' (números, strings, 'e' seguido
+ * de um char), para que os '[' e ']' dentro de strings sejam ignorados.
+ * 
+ * @warning A nova linha é criada com o "malloc", logo tem que ser libertada depois usando a função 'line_Dispose'.
+ * @param text Texto da linha (não é copiado)
+ * @param size Tamanho do texto
+ * @returns Nova linha
+ */
+Line* line_Create(char* text, int size)
+{
+    Line* line = malloc(sizeof(Line));
+    line->text = text;
+    line->size = size;
+    line->match = malloc((size + 1) * sizeof(int));
+    int* open = malloc((size + 1) * sizeof(int));
+    int depth = 0, pos = 0;
+    for (int i = 0; i <= size; i++)
+        line->match[i] = -1;
+    while (pos < size)
+    {
+        char c = text[pos];
+        int number = (c != ' ' && c > 31) ? line_p_NumberLength(text + pos) : 0;
+        if (c == ' ' || c <= 31)
+            pos++;
+        else if (number > 0)
+            pos += number;
+        else if (c == '\"')
+        {
+            int end = utils_NextChar(text, pos + 1, '\"');
+            line->match[pos] = (end > size) ? size : end;
+            pos = end + 1;
+        }
+        else if (c == 'e') // O 'e' consome sempre o char seguinte
+            pos += 2;
+        else
+        {
+            if (c == '[' || c == '{')
+                open[depth++] = pos;
+            else if (c == ']' || c == '}')
+                line_p_Close(line, open, &depth, pos);
+            pos++;
+        }
+    }
+    while (depth > 0)
+        line->match[open[--depth]] = size;
+    free(open);
+    return line;
+}
+
+/** @brief Liberta a memória ocupada pela linha (o texto não é libertado).
+ * 
+ * @param line Apontador para a linha
+ */
+void line_Dispose(Line* line)
+{
+    free(line->match);
+    free(line);
+}
+
+/** @brief Procura o par de um '[', '{' ou '"'.
+ * 
+ * @param line Apontador para a linha
+ * @param pos Posição do char que abre
+ * @returns Indice do char que fecha, ou o tamanho da linha se este não existir
+ */
+int line_FindMatch(Line* line, int pos)
+{
+    if (pos < 0 || pos >= line->size || line->match[pos] < 0)
+        return line->size;
+    return line->match[pos];
+}
+
+
+
+// Parser
+
+/** @brief Verifica se a entrada tem um número (double ou long) e compila-o como constante
+ * 
+ * @param code Apontador para o código
+ * @param line Apontador para a linha
  * @param linePos Posição na linha
- * @param outN Variável de saida, usada apenas para testes
  * @returns 1 se tiver sucesso
  */
-int parser_InputNumber(Stack* stack, char* line, int* linePos, double* outN)
+int parser_p_CompileNumber(Code* code, Line* line, int* linePos)
 {
-    double input = 0; int pos = *linePos, offset = 0;
-    if (sscanf(line + pos, "%lg%n", &input, &offset) != 1)
+    double input = 0; int pos = *linePos;
+    int offset = line_p_ReadNumber(line->text + pos, &input);
+    if (offset == 0)
         return 0;
     // Se existir um '.' no espaço, quer dizer que o número é um double
-    if (utils_FindCharSub(line + pos, offset, '.') != -1)
-         stack_Push(stack, icreate_Double(input));
-    else stack_Push(stack, icreate_Long(input));
-    *outN = input;
+    Item* value;
+    if (utils_FindCharSub(line->text + pos, offset, '.') != -1)
+         value = icreate_Double(input);
+    else value = icreate_Long(input);
+    code_Add(code, OP_Push, line->text[pos], value, NULL, pos);
     *linePos += offset;
     return 1;
 }
 
-/** @brief Verifica se a entrada tem um char de um comando e executa-o
+/** @brief Compila uma parte de uma linha já pré-processada
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
- * @param line Linha da entrada
- * @param linePos Posição na linha
- * @param outN Variável de saida, usada apenas para testes
- * @returns 1 se tiver sucesso
+ * Strings, arrays, blocos e variáveis são resolvidos aqui (com a tabela dos pares),
+ * para a execução não ter que voltar a ler o texto.
+ * 
+ * @warning O novo código é criado com o "malloc", logo tem que ser libertado depois usando a função 'code_Dispose'.
+ * @param line Apontador para a linha
+ * @param start Indice do inicio
+ * @param end Indice do fim (exclusivo)
+ * @returns Código compilado
  */
-int parser_InputCmd(Item** vars, Stack* stack, char* line, int* linePos, char* outN)
+Code* parser_Compile(Line* line, int start, int end)
 {
-    char input = 0; int pos = *linePos, offset = 0;
-    if (sscanf(line + pos, "%c%n", &input, &offset) != 1)
-        return 0;
-    *linePos += offset;
-    if (input == ' ' || input == '\n')
-        return 1;
-    *outN = input;
-    if (!handler_Handle(vars, stack, input, line, linePos))
+    Code* code = code_Create();
+    char* text = line->text;
+    int pos = start;
+    while (pos < end)
     {
-        // debug
-        if (input > 10)
-            printf("Can't handle command '%d'\n", input);
-        return 0;
+        char c = text[pos];
+        if (c == ' ' || c <= 31)
+        {
+            pos++;
+            continue;
+        }
+        if (parser_p_CompileNumber(code, line, &pos))
+            continue;
+        pos++;
+        if (c == '\"' || c == '[' || c == '{')
+        {
+            int match = line_FindMatch(line, pos - 1);
+            if (match > end) match = end;
+            if (c == '\"')
+                code_Add(code, OP_Push, c, icreate_String(utils_Substring(text + pos, match - pos), match - pos), NULL, pos - 1);
+            else if (c == '[')
+                code_Add(code, OP_Array, c, NULL, parser_Compile(line, pos, match), pos - 1);
+            else
+            {
+                Item* block = icreate_Block(utils_Substring(text + pos, match - pos), match - pos, parser_Compile(line, pos, match));
+                code_Add(code, OP_Push, c, block, NULL, pos - 1);
+            }
+            pos = match + 1;
+        }
+        else if (c == ':' && text[pos] >= 'A' && text[pos] <= 'Z')
+        {
+            code_Add(code, OP_SetVar, text[pos], NULL, NULL, pos - 1);
+            pos++;
+        }
+        else if (c == 'e') // O 'e' consome sempre o char seguinte
+        {
+            code_Add(code, OP_ECmd, text[pos], NULL, NULL, pos - 1);
+            pos++;
+        }
+        else code_Add(code, OP_Cmd, c, NULL, NULL, pos - 1);
     }
-    return 1;
+    return code;
 }
 
-
+/** @brief Compila uma linha para o programa do interpretador (substitui o anterior).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param line Linha da entrada
+ * @param lineSize Tamanho da linha
+ */
+void parser_p_Load(Interp* ip, char* line, int lineSize)
+{
+    Line* l = line_Create(line, lineSize);
+    if (ip->code != NULL)
+        code_Dispose(ip->code);
+    ip->code = parser_Compile(l, 0, lineSize);
+    line_Dispose(l);
+}
 
 /** @brief Processa uma linha
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * A linha é compilada uma vez e o código, que fica guardado no interpretador, é depois
+ * executado pela máquina virtual.
+ * 
+ * @param ip Apontador para o interpretador
  * @param line Linha da entrada
- * @param linePos Posição na linha
+ * @param lineSize Tamanho da linha
  * @returns O resultado do processo do ultimo char, não tem grande uso
  */
-int parser_Process(Item** vars, Stack* stack, char* line, int lineSize)
+int parser_Process(Interp* ip, char* line, int lineSize)
 {
-    int linePos = 0, r = 0; double discardD; char discardC;
-    while (linePos < lineSize)
-    {
-        if (line[linePos] != ' ' && line[linePos] > 31)
-            r = parser_InputNumber(stack, line, &linePos, &discardD) ||
-                parser_InputCmd(vars, stack, line, &linePos, &discardC);
-        else linePos++;
-    }
+    parser_p_Load(ip, line, lineSize);
+    int r = vm_Run(ip, ip->code);
+    // Um 'b' fora de um ciclo termina o programa
+    vm_TakeBreak(ip);
     return r;
 }
 
 /** @brief Processa uma linha imprimindo detalhes sobre cada passo
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param line Linha da entrada
- * @param linePos Posição na linha
+ * @param lineSize Tamanho da linha
  * @returns O resultado do processo do ultimo char, não tem grande uso
  */
-int parser_DebugProcess(Item** vars, Stack* stack, char* line, int lineSize)
+int parser_DebugProcess(Interp* ip, char* line, int lineSize)
 {
-    int linePos = 0, r = 0; double inpD; char inpC;
-    printf("\nLine Size: %d\n\n", lineSize);
-    while (linePos < lineSize)
-    {
-        if (line[linePos] != ' ' && line[linePos] > 31)
-        {
-            if (parser_InputNumber(stack, line, &linePos, &inpD))
-                printf("N: '%lg'\n", inpD);
-            else if (parser_InputCmd(vars, stack, line, &linePos, &inpC))
-            {
-                char* is = i_ToString(stack_Peek(stack));
-                printf("C: '%c': '%s'\n", inpC, is);
-                free(is);
-            }
-            stack_PrintWS(stack);
-            printf("\n\n");
-        }
-        else linePos++;
-    }
-    printf("\nResult:\n");
+    parser_p_Load(ip, line, lineSize);
+    fprintf(ip->io.out, "\nLine Size: %d\n\n", lineSize);
+    int r = vm_DebugRun(ip, ip->code);
+    vm_TakeBreak(ip);
+    fprintf(ip->io.out, "\nResult:\n");
     return r;
 }
@@ -4,28 +4,69 @@
 
 #pragma once
 
+#include "code.h"
+#include "interp.h"
+
+/**
+ * Linha de entrada pré-processada, com a tabela dos pares de '[]', '{}' e '""'
+ */
+typedef struct LineT
+{
+    char* text;     /*!< Texto da linha */
+    int size;       /*!< Tamanho do texto */
+    int* match;     /*!< Para cada '[', '{' ou '"', o indice do par correspondente (-1 nas outras posições) */
+} Line;
+
+
+/** @brief Cria uma linha e calcula, numa só passagem, a tabela dos pares.
+ * 
+ * @warning A nova linha é criada com o "malloc", logo tem que ser libertada depois usando a função 'line_Dispose'.
+ * @param text Texto da linha (não é copiado)
+ * @param size Tamanho do texto
+ * @returns Nova linha
+ */
+Line* line_Create(char* text, int size);
+
+/** @brief Liberta a memória ocupada pela linha (o texto não é libertado).
+ * 
+ * @param line Apontador para a linha
+ */
+void line_Dispose(Line* line);
+
+/** @brief Procura o par de um '[', '{' ou '"'.
+ * 
+ * @param line Apontador para a linha
+ * @param pos Posição do char que abre
+ * @returns Indice do char que fecha, ou o tamanho da linha se este não existir
+ */
+int line_FindMatch(Line* line, int pos);
+
+
+
+/** @brief Compila uma parte de uma linha já pré-processada
+ * 
+ * @warning O novo código é criado com o "malloc", logo tem que ser libertado depois usando a função 'code_Dispose'.
+ * @param line Apontador para a linha
+ * @param start Indice do inicio
+ * @param end Indice do fim (exclusivo)
+ * @returns Código compilado
+ */
+Code* parser_Compile(Line* line, int start, int end);
 
 /** @brief Processa uma linha
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param line Linha da entrada
- * @param linePos Posição na linha
+ * @param lineSize Tamanho da linha
  * @returns O resultado do processo do ultimo char, não tem grande uso
  */
-int parser_Process(Item** vars, Stack* stack, char* line, int lineSize);
+int parser_Process(Interp* ip, char* line, int lineSize);
 
 /** @brief Processa uma linha imprimindo detalhes sobre cada passo
  * 
- * @param vars Apontador para o array de variáveis
- * @param stack Apontador para o stack
+ * @param ip Apontador para o interpretador
  * @param line Linha da entrada
- * @param linePos Posição na linha
+ * @param lineSize Tamanho da linha
  * @returns O resultado do processo do ultimo char, não tem grande uso
  */
-int parser_DebugProcess(Item** vars, Stack* stack, char* line, int lineSize);
-
-
-
-
-
+int parser_DebugProcess(Interp* ip, char* line, int lineSize);
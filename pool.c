@@ -0,0 +1,235 @@
+/**
+ * @file Thread pool com roubo de trabalho (work stealing), usada para dividir ciclos grandes pelos cores
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+
+/** Pool partilhada, criada pelo 'pool_SetThreads' */
+static Pool* pool_p_default = NULL;
+
+
+// Filas
+
+/** @brief Tira o ultimo pedaço da fila do próprio worker.
+ * 
+ * @param deque Apontador para a fila
+ * @returns Indice do pedaço, ou -1 se a fila estiver vazia
+ */
+int pool_p_Pop(PoolDeque* deque)
+{
+    int chunk = -1;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top)
+        chunk = deque->chunks[--deque->bottom];
+    pthread_mutex_unlock(&deque->lock);
+    return chunk;
+}
+
+/** @brief Rouba o primeiro pedaço da fila de outro worker.
+ * 
+ * @param deque Apontador para a fila
+ * @returns Indice do pedaço, ou -1 se a fila estiver vazia
+ */
+int pool_p_Steal(PoolDeque* deque)
+{
+    int chunk = -1;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top)
+        chunk = deque->chunks[deque->top++];
+    pthread_mutex_unlock(&deque->lock);
+    return chunk;
+}
+
+/** @brief Executa pedaços até não haver mais nenhum (primeiro os seus, depois os roubados).
+ * 
+ * @param pool Apontador para a pool
+ * @param worker Indice do worker
+ */
+void pool_p_Work(Pool* pool, int worker)
+{
+    while (1)
+    {
+        int chunk = pool_p_Pop(&pool->deques[worker]);
+        for (int i = 1; chunk < 0 && i < pool->count; i++)
+            chunk = pool_p_Steal(&pool->deques[(worker + i) % pool->count]);
+        if (chunk < 0)
+            return;
+        pool->task(pool->context, chunk, worker);
+    }
+}
+
+/**
+ * Argumentos de uma thread da pool
+ */
+typedef struct PoolThreadArgsT
+{
+    Pool* pool;     /*!< Apontador para a pool */
+    int worker;     /*!< Indice do worker */
+} PoolThreadArgs;
+
+/** @brief Função principal de uma thread da pool: espera por trabalhos e executa-os.
+ * 
+ * @param args Apontador para os argumentos (são libertados aqui)
+ * @returns NULL
+ */
+void* pool_p_Thread(void* args)
+{
+    Pool* pool = ((PoolThreadArgs*)args)->pool;
+    int worker = ((PoolThreadArgs*)args)->worker, seen = 0;
+    free(args);
+    while (1)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == seen)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_p_Work(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+
+
+// Pool
+
+/** @brief Cria uma thread pool.
+ * 
+ * @warning A nova pool é criada com o "malloc", logo tem que ser libertada depois usando a função 'pool_Dispose'.
+ * @param count Quantidade de workers (incluindo a thread que chama o 'pool_Run')
+ * @returns Nova pool
+ */
+Pool* pool_Create(int count)
+{
+    Pool* pool = calloc(1, sizeof(Pool));
+    pool->count = count;
+    pool->deques = calloc(count, sizeof(PoolDeque));
+    for (int i = 0; i < count; i++)
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->threads = malloc(count * sizeof(pthread_t));
+    for (int i = 1; i < count; i++)
+    {
+        PoolThreadArgs* args = malloc(sizeof(PoolThreadArgs));
+        args->pool = pool;
+        args->worker = i;
+        pthread_create(&pool->threads[i], NULL, pool_p_Thread, args);
+    }
+    return pool;
+}
+
+/** @brief Pára as threads e liberta a memória ocupada pela pool.
+ * 
+ * @param pool Apontador para a pool
+ */
+void pool_Dispose(Pool* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 1; i < pool->count; i++)
+        pthread_join(pool->threads[i], NULL);
+    for (int i = 0; i < pool->count; i++)
+    {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].chunks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->deques);
+    free(pool->threads);
+    free(pool);
+}
+
+/** @brief Executa a função para todos os pedaços, dividindo-os pelos workers, e espera que acabem.
+ * 
+ * Cada worker começa com uma parte seguida dos pedaços (para os dados ficarem perto uns
+ * dos outros), e quando acaba a sua parte rouba pedaços aos outros.
+ * Se a pool já estiver ocupada (por exemplo, dentro de um pedaço de outro trabalho),
+ * os pedaços são executados na thread que chama, um a seguir ao outro.
+ * 
+ * @param pool Apontador para a pool
+ * @param chunks Quantidade de pedaços
+ * @param task Função a executar para cada pedaço
+ * @param context Contexto passado à função
+ */
+void pool_Run(Pool* pool, int chunks, PoolTask task, void* context)
+{
+    pthread_mutex_lock(&pool->lock);
+    int busy = pool->busy;
+    pool->busy = 1;
+    pthread_mutex_unlock(&pool->lock);
+    if (busy)
+    {
+        for (int i = 0; i < chunks; i++)
+            task(context, i, 0);
+        return;
+    }
+    for (int w = 0; w < pool->count; w++)
+    {
+        PoolDeque* deque = &pool->deques[w];
+        int from = (int)((long)chunks * w / pool->count), to = (int)((long)chunks * (w + 1) / pool->count);
+        free(deque->chunks);
+        deque->chunks = malloc((to - from + 1) * sizeof(int));
+        // A ordem é invertida para o dono tirar (do fim) os pedaços pela ordem original
+        for (int i = from; i < to; i++)
+            deque->chunks[to - 1 - i] = i;
+        deque->top = 0;
+        deque->bottom = to - from;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->active = pool->count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_p_Work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pool->busy = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/** @brief Muda a quantidade de threads da pool partilhada (1 ou menos desliga o modo paralelo).
+ * 
+ * @param count Quantidade de threads
+ */
+void pool_SetThreads(int count)
+{
+    if (count > PoolMaxThreads)
+        count = PoolMaxThreads;
+    if (pool_p_default != NULL)
+        pool_Dispose(pool_p_default);
+    pool_p_default = (count > 1) ? pool_Create(count) : NULL;
+}
+
+/** @brief Dá a pool partilhada.
+ * 
+ * @returns Apontador para a pool, ou NULL se o modo paralelo estiver desligado
+ */
+Pool* pool_Default()
+{
+    return pool_p_default;
+}
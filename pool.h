@@ -0,0 +1,82 @@
+/**
+ * @file Thread pool com roubo de trabalho (work stealing), usada para dividir ciclos grandes pelos cores
+ */
+
+#pragma once
+
+#include <pthread.h>
+
+/** Quantidade máxima de threads aceite no '--threads' */
+#define PoolMaxThreads 256
+
+/** Função executada para cada pedaço do trabalho (worker é o indice da thread, de 0 a count - 1) */
+typedef void (*PoolTask)(void* context, int chunk, int worker);
+
+/**
+ * Fila de pedaços de um worker. O dono tira do fim, os outros roubam do inicio.
+ */
+typedef struct PoolDequeT
+{
+    int* chunks;            /*!< Indices dos pedaços */
+    int top;                /*!< Indice do primeiro pedaço (onde se rouba) */
+    int bottom;             /*!< Indice depois do ultimo pedaço (onde o dono tira) */
+    pthread_mutex_t lock;   /*!< Protege o top e o bottom */
+} PoolDeque;
+
+/**
+ * Thread pool. O worker 0 é sempre a thread que chama o 'pool_Run'.
+ */
+typedef struct PoolT
+{
+    pthread_t* threads;     /*!< Threads dos workers 1 a count - 1 */
+    PoolDeque* deques;      /*!< Uma fila por worker */
+    int count;              /*!< Quantidade de workers (incluindo a thread que chama) */
+    pthread_mutex_t lock;   /*!< Protege os campos abaixo */
+    pthread_cond_t start;   /*!< Sinal para os workers começarem um trabalho novo */
+    pthread_cond_t done;    /*!< Sinal de que todos os workers acabaram */
+    int generation;         /*!< Número do trabalho atual (muda a cada 'pool_Run') */
+    int active;             /*!< Workers que ainda não acabaram o trabalho atual */
+    int busy;               /*!< 1 enquanto um trabalho está a correr */
+    int stop;               /*!< 1 quando a pool vai ser libertada */
+    PoolTask task;          /*!< Função do trabalho atual */
+    void* context;          /*!< Contexto do trabalho atual */
+} Pool;
+
+
+/** @brief Cria uma thread pool.
+ * 
+ * @warning A nova pool é criada com o "malloc", logo tem que ser libertada depois usando a função 'pool_Dispose'.
+ * @param count Quantidade de workers (incluindo a thread que chama o 'pool_Run')
+ * @returns Nova pool
+ */
+Pool* pool_Create(int count);
+
+/** @brief Pára as threads e liberta a memória ocupada pela pool.
+ * 
+ * @param pool Apontador para a pool
+ */
+void pool_Dispose(Pool* pool);
+
+/** @brief Executa a função para todos os pedaços, dividindo-os pelos workers, e espera que acabem.
+ * 
+ * Se a pool já estiver ocupada (por exemplo, dentro de um pedaço de outro trabalho),
+ * os pedaços são executados na thread que chama, um a seguir ao outro.
+ * 
+ * @param pool Apontador para a pool
+ * @param chunks Quantidade de pedaços
+ * @param task Função a executar para cada pedaço
+ * @param context Contexto passado à função
+ */
+void pool_Run(Pool* pool, int chunks, PoolTask task, void* context);
+
+/** @brief Muda a quantidade de threads da pool partilhada (1 ou menos desliga o modo paralelo).
+ * 
+ * @param count Quantidade de threads
+ */
+void pool_SetThreads(int count);
+
+/** @brief Dá a pool partilhada.
+ * 
+ * @returns Apontador para a pool, ou NULL se o modo paralelo estiver desligado
+ */
+Pool* pool_Default();
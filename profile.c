@@ -0,0 +1,371 @@
+/**
+ * @file Profiler: conta as execuções, o tempo e as alocações de cada comando, família de handlers e posição do programa
+ * 
+ * Com os contadores do processador ligados (ver o 'counters.h') conta também os ciclos, as instruções, os cache
+ * misses e os branch misses de cada um.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+/** Unidade dos ticks */
+#define ProfileTickUnit "tsc"
+#else
+/** Unidade dos ticks */
+#define ProfileTickUnit "ns"
+#endif
+
+#include "allocs.h"
+#include "profile.h"
+
+/** Tamanho máximo do nome de uma linha das tabelas */
+#define ProfileLabelSize 24
+/** Quantidade de chars do programa mostrados em cada posição */
+#define ProfileSourceSize 12
+
+/**
+ * Uma linha de uma tabela
+ */
+typedef struct ProfileRowT
+{
+    char label[ProfileLabelSize];   /*!< Nome da linha */
+    ProfileEntry* entry;            /*!< Valores */
+} ProfileRow;
+
+/** Nome de cada família de handlers */
+static const char* profile_p_hubNames[PH_Count] =
+{
+    "vm", "hHub_Vars", "hHub_Block", "hHub_Math", "hHub_Stack",
+    "hHub_Array", "hHub_Logic", "hHub_EBlock", "hHub_ELogic", "hHub_EVars", "(none)"
+};
+
+// Ticks, bytes e contadores das instruções já acabadas dentro da instrução atual (de cada thread)
+static __thread long profile_p_childTicks, profile_p_childBytes, profile_p_childCounters[CT_Count];
+
+
+/** @brief Cria um profiler vazio.
+ * 
+ * @warning O novo profiler é criado com o "malloc", logo tem que ser libertado depois usando a função 'profile_Dispose'.
+ * @param positionCount Tamanho do programa, para contar cada posição (0 para não contar)
+ * @returns Novo profiler
+ */
+Profile* profile_Create(int positionCount)
+{
+    Profile* profile = calloc(1, sizeof(Profile));
+    if (positionCount > 0)
+    {
+        profile->positions = calloc(positionCount, sizeof(ProfileEntry));
+        profile->positionCount = positionCount;
+    }
+    return profile;
+}
+
+/** @brief Liberta o profiler.
+ * 
+ * @param profile Apontador para o profiler
+ */
+void profile_Dispose(Profile* profile)
+{
+    free(profile->positions);
+    free(profile);
+}
+
+/** @brief Lê o relógio do profiler (o TSC nos x86, nanosegundos nas outras arquiteturas).
+ * 
+ * @returns Ticks
+ */
+long profile_Ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (long)__rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+#endif
+}
+
+/** @brief Começa a medir uma instrução.
+ * 
+ * @param frame Estado da instrução
+ */
+void profile_Begin(ProfileFrame* frame)
+{
+    // Os contadores são lidos por fora dos ticks, para a chamada ao sistema não contar no tempo
+    if (counters_Enabled())
+    {
+        memcpy(frame->childCounters, profile_p_childCounters, sizeof(profile_p_childCounters));
+        memset(profile_p_childCounters, 0, sizeof(profile_p_childCounters));
+        counters_Read(frame->counters);
+    }
+    frame->childTicks = profile_p_childTicks;
+    frame->childBytes = profile_p_childBytes;
+    profile_p_childTicks = 0;
+    profile_p_childBytes = 0;
+    frame->bytes = allocs_Bytes();
+    frame->start = profile_Ticks();
+}
+
+/** @brief Calcula a chave do comando de uma instrução.
+ * 
+ * @param ins Apontador para a instrução
+ * @returns Chave
+ */
+int profile_p_Key(Instruction* ins)
+{
+    switch (ins->op)
+    {
+        case OP_Push:
+            if (ins->value->type == TBlock)
+                return ProfileKeyBlock;
+            return (ins->value->type == TString) ? ProfileKeyString : ProfileKeyNumber;
+        case OP_Array:
+            return ProfileKeyArray;
+        case OP_SetVar:
+            return ProfileKeySetVar;
+        case OP_ECmd:
+            return ProfileKeyECmd + (unsigned char)ins->cmd;
+        default:
+            return (unsigned char)ins->cmd;
+    }
+}
+
+/** @brief Junta uma execução aos valores.
+ * 
+ * @param entry Apontador para os valores
+ * @param total Ticks da execução
+ * @param self Ticks sem as instruções de dentro
+ * @param bytes Bytes alocados sem as instruções de dentro
+ * @param counters Contadores sem as instruções de dentro (NULL se estão desligados)
+ */
+void profile_p_Add(ProfileEntry* entry, long total, long self, long bytes, long* counters)
+{
+    entry->count++;
+    entry->total += total;
+    entry->self += self;
+    entry->bytes += bytes;
+    if (counters != NULL)
+        for (int c = 0; c < CT_Count; c++)
+            entry->counters[c] += counters[c];
+}
+
+/** @brief Acaba de ler os contadores de uma instrução.
+ * 
+ * @param frame Estado dado ao 'profile_Begin'
+ * @param self Out: contadores sem as instruções de dentro
+ */
+void profile_p_EndCounters(ProfileFrame* frame, long* self)
+{
+    long now[CT_Count];
+    counters_Read(now);
+    for (int c = 0; c < CT_Count; c++)
+    {
+        long total = now[c] - frame->counters[c];
+        self[c] = total - profile_p_childCounters[c];
+        profile_p_childCounters[c] = frame->childCounters[c] + total;
+    }
+}
+
+/** @brief Acaba de medir uma instrução e junta os valores aos do comando, da família e da posição.
+ * 
+ * O tempo de uma instrução é descontado no 'self' da instrução que a executou, se for na mesma thread.
+ * 
+ * @param profile Apontador para o profiler
+ * @param frame Estado dado ao 'profile_Begin'
+ * @param ins Instrução executada
+ * @param hub Família que a tratou
+ */
+void profile_End(Profile* profile, ProfileFrame* frame, Instruction* ins, ProfileHub hub)
+{
+    long total = profile_Ticks() - frame->start;
+    long bytes = allocs_Bytes() - frame->bytes;
+    long self = total - profile_p_childTicks, selfBytes = bytes - profile_p_childBytes;
+    long selfCounters[CT_Count], *counters = NULL;
+    profile_p_childTicks = frame->childTicks + total;
+    profile_p_childBytes = frame->childBytes + bytes;
+    if (counters_Enabled())
+    {
+        profile_p_EndCounters(frame, selfCounters);
+        counters = selfCounters;
+    }
+    profile_p_Add(&profile->commands[profile_p_Key(ins)], total, self, selfBytes, counters);
+    profile_p_Add(&profile->hubs[hub], total, self, selfBytes, counters);
+    if (ins->pos >= 0 && ins->pos < profile->positionCount)
+        profile_p_Add(&profile->positions[ins->pos], total, self, selfBytes, counters);
+}
+
+/** @brief Junta os valores de uma array aos de outra.
+ * 
+ * @param entries Valores que recebem
+ * @param others Valores de onde vêm
+ * @param n Quantidade de valores
+ */
+void profile_p_MergeEntries(ProfileEntry* entries, ProfileEntry* others, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        entries[i].count += others[i].count;
+        entries[i].total += others[i].total;
+        entries[i].self += others[i].self;
+        entries[i].bytes += others[i].bytes;
+        for (int c = 0; c < CT_Count; c++)
+            entries[i].counters[c] += others[i].counters[c];
+    }
+}
+
+/** @brief Junta os valores de um profiler aos de outro.
+ * 
+ * @param profile Profiler que recebe os valores
+ * @param other Profiler de onde vêm
+ */
+void profile_Merge(Profile* profile, Profile* other)
+{
+    profile_p_MergeEntries(profile->commands, other->commands, ProfileKeyCount);
+    profile_p_MergeEntries(profile->hubs, other->hubs, PH_Count);
+    int n = (profile->positionCount < other->positionCount) ? profile->positionCount : other->positionCount;
+    profile_p_MergeEntries(profile->positions, other->positions, n);
+}
+
+/** @brief Escreve o nome de um comando.
+ * 
+ * @param key Chave do comando
+ * @param label Buffer com 'ProfileLabelSize' chars
+ */
+void profile_p_Label(int key, char* label)
+{
+    if (key == ProfileKeyNumber)
+        strcpy(label, "number");
+    else if (key == ProfileKeyString)
+        strcpy(label, "\"...\"");
+    else if (key == ProfileKeyBlock)
+        strcpy(label, "{...}");
+    else if (key == ProfileKeyArray)
+        strcpy(label, "[...]");
+    else if (key == ProfileKeySetVar)
+        strcpy(label, ":X");
+    else
+    {
+        int c = key % ProfileKeyECmd;
+        char* prefix = (key >= ProfileKeyECmd) ? "e" : "";
+        if (c > 32 && c < 127)
+            snprintf(label, ProfileLabelSize, "%s%c", prefix, c);
+        else snprintf(label, ProfileLabelSize, "%s\\x%02x", prefix, c);
+    }
+}
+
+/** @brief Escreve a posição de uma instrução com o inicio do texto que lá está.
+ * 
+ * @param program Texto do programa
+ * @param pos Posição
+ * @param label Buffer com 'ProfileLabelSize' chars
+ */
+void profile_p_PositionLabel(char* program, int pos, char* label)
+{
+    int n = snprintf(label, ProfileLabelSize, "%d:", pos);
+    for (int i = pos; i < pos + ProfileSourceSize && program[i] != '\0' && program[i] != '\n'; i++)
+        label[n++] = (program[i] >= 32 && program[i] < 127) ? program[i] : '?';
+    label[n] = '\0';
+}
+
+/** @brief Compara duas linhas pelo 'self' (a maior primeiro), para o qsort.
+ * 
+ * @param a Apontador para a primeira
+ * @param b Apontador para a segunda
+ * @returns Negativo, zero ou positivo
+ */
+int profile_p_CompareRows(const void* a, const void* b)
+{
+    long x = ((const ProfileRow*)a)->entry->self, y = ((const ProfileRow*)b)->entry->self;
+    return (x < y) - (x > y);
+}
+
+/** @brief Ordena e escreve uma tabela (só as linhas que foram executadas).
+ * 
+ * @param title Título da primeira coluna
+ * @param rows Linhas
+ * @param n Quantidade de linhas
+ * @param out Ficheiro onde se escreve
+ */
+void profile_p_PrintTable(char* title, ProfileRow* rows, int n, FILE* out)
+{
+    long all = 0;
+    for (int i = 0; i < n; i++)
+        all += rows[i].entry->self;
+    qsort(rows, n, sizeof(ProfileRow), profile_p_CompareRows);
+    fprintf(out, "%-24s %12s %16s %16s %7s", title, "count", "total", "self", "self%");
+    if (allocs_Enabled())
+        fprintf(out, " %14s", "bytes");
+    for (int c = 0; c < CT_Count; c++)
+        if (counters_Available(c))
+            fprintf(out, " %14s", counters_Name(c));
+    int ipc = counters_Available(CT_Cycles) && counters_Available(CT_Instructions);
+    if (ipc)
+        fprintf(out, " %6s", "ipc");
+    fprintf(out, "\n");
+    for (int i = 0; i < n; i++)
+    {
+        ProfileEntry* e = rows[i].entry;
+        fprintf(out, "%-24s %12ld %16ld %16ld %6.2f%%", rows[i].label, e->count, e->total, e->self,
+            all ? 100.0 * e->self / all : 0.0);
+        if (allocs_Enabled())
+            fprintf(out, " %14ld", e->bytes);
+        for (int c = 0; c < CT_Count; c++)
+            if (counters_Available(c))
+                fprintf(out, " %14ld", e->counters[c]);
+        if (ipc)
+            fprintf(out, " %6.2f", e->counters[CT_Cycles] ? (double)e->counters[CT_Instructions] / e->counters[CT_Cycles] : 0.0);
+        fprintf(out, "\n");
+    }
+    fprintf(out, "\n");
+}
+
+/** @brief Escreve as tabelas dos comandos, das famílias e das posições, ordenadas pelo 'self'.
+ * 
+ * Os bytes só aparecem se o programa foi compilado com a contagem das alocações (ver o 'allocs.h'), e os
+ * contadores do processador se estiverem ligados.
+ * 
+ * @param profile Apontador para o profiler
+ * @param program Texto do programa (para mostrar cada posição)
+ * @param out Ficheiro onde se escreve
+ */
+void profile_Print(Profile* profile, char* program, FILE* out)
+{
+    int max = (ProfileKeyCount > profile->positionCount) ? ProfileKeyCount : profile->positionCount;
+    ProfileRow* rows = malloc(max * sizeof(ProfileRow));
+    int n = 0;
+    fprintf(out, "profile: ticks=" ProfileTickUnit "\n");
+
+    for (int key = 0; key < ProfileKeyCount; key++)
+        if (profile->commands[key].count > 0)
+        {
+            profile_p_Label(key, rows[n].label);
+            rows[n++].entry = &profile->commands[key];
+        }
+    profile_p_PrintTable("command", rows, n, out);
+
+    n = 0;
+    for (int hub = 0; hub < PH_Count; hub++)
+        if (profile->hubs[hub].count > 0)
+        {
+            strcpy(rows[n].label, profile_p_hubNames[hub]);
+            rows[n++].entry = &profile->hubs[hub];
+        }
+    profile_p_PrintTable("handler", rows, n, out);
+
+    if (profile->positions != NULL)
+    {
+        n = 0;
+        for (int pos = 0; pos < profile->positionCount; pos++)
+            if (profile->positions[pos].count > 0)
+            {
+                profile_p_PositionLabel(program, pos, rows[n].label);
+                rows[n++].entry = &profile->positions[pos];
+            }
+        profile_p_PrintTable("position", rows, n, out);
+    }
+    free(rows);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file Profiler: conta as execuções, o tempo e as alocações de cada comando, família de handlers e posição do programa
+ * 
+ * Com os contadores do processador ligados (ver o 'counters.h') conta também os ciclos, as instruções, os cache
+ * misses e os branch misses de cada um.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "code.h"
+#include "counters.h"
+
+/** Chaves dos comandos: os chars (0-255), os 'e' seguidos de um char (256-511) e as instruções que não são comandos */
+#define ProfileKeyECmd 256
+/** Chave dos números guardados no stack */
+#define ProfileKeyNumber 512
+/** Chave das strings guardadas no stack */
+#define ProfileKeyString 513
+/** Chave dos blocos guardados no stack */
+#define ProfileKeyBlock 514
+/** Chave dos arrays ('[' ... ']') */
+#define ProfileKeyArray 515
+/** Chave das atribuições às variáveis (':' seguido de uma letra) */
+#define ProfileKeySetVar 516
+/** Quantidade de chaves */
+#define ProfileKeyCount 517
+
+/**
+ * Família de handlers (o hub) que tratou uma instrução
+ */
+typedef enum ProfileHubT
+{
+    PH_Vm,          /*!< Instruções tratadas pela própria máquina virtual (constantes, arrays e variáveis) */
+    PH_Vars,        /*!< hHub_Vars */
+    PH_Block,       /*!< hHub_Block */
+    PH_Math,        /*!< hHub_Math */
+    PH_Stack,       /*!< hHub_Stack */
+    PH_Array,       /*!< hHub_Array */
+    PH_Logic,       /*!< hHub_Logic */
+    PH_EBlock,      /*!< hHub_EBlock */
+    PH_ELogic,      /*!< hHub_ELogic */
+    PH_EVars,       /*!< hHub_EVars */
+    PH_None,        /*!< Nenhum handler aceitou o comando */
+    PH_Count,       /*!< Quantidade de famílias */
+} ProfileHub;
+
+/**
+ * Valores acumulados de uma chave, família ou posição
+ */
+typedef struct ProfileEntryT
+{
+    long count;     /*!< Execuções */
+    long total;     /*!< Ticks desde o inicio até ao fim de cada execução */
+    long self;      /*!< Ticks sem contar as instruções executadas lá dentro (arrays e blocos) */
+    long bytes;     /*!< Bytes alocados, sem contar as instruções executadas lá dentro */
+    long counters[CT_Count];    /*!< Contadores do processador, sem contar as instruções executadas lá dentro */
+} ProfileEntry;
+
+/**
+ * Profiler de um interpretador
+ */
+typedef struct ProfileT
+{
+    ProfileEntry commands[ProfileKeyCount]; /*!< Valores de cada comando */
+    ProfileEntry hubs[PH_Count];            /*!< Valores de cada família de handlers */
+    ProfileEntry* positions;                /*!< Valores de cada posição do programa (NULL se não foram pedidos) */
+    int positionCount;                      /*!< Tamanho de 'positions' */
+} Profile;
+
+/**
+ * Estado de uma instrução enquanto é executada (fica no stack de quem a executa)
+ */
+typedef struct ProfileFrameT
+{
+    long start;         /*!< Ticks no inicio */
+    long bytes;         /*!< Bytes alocados até ao inicio */
+    long childTicks;    /*!< Ticks das instruções de fora, guardados até esta acabar */
+    long childBytes;    /*!< Bytes das instruções de fora, guardados até esta acabar */
+    long counters[CT_Count];        /*!< Contadores do processador no inicio (só com os contadores ligados) */
+    long childCounters[CT_Count];   /*!< Contadores das instruções de fora, guardados até esta acabar */
+} ProfileFrame;
+
+
+/** @brief Cria um profiler vazio.
+ * 
+ * @warning O novo profiler é criado com o "malloc", logo tem que ser libertado depois usando a função 'profile_Dispose'.
+ * @param positionCount Tamanho do programa, para contar cada posição (0 para não contar)
+ * @returns Novo profiler
+ */
+Profile* profile_Create(int positionCount);
+
+/** @brief Liberta o profiler.
+ * 
+ * @param profile Apontador para o profiler
+ */
+void profile_Dispose(Profile* profile);
+
+/** @brief Lê o relógio do profiler (o TSC nos x86, nanosegundos nas outras arquiteturas).
+ * 
+ * @returns Ticks
+ */
+long profile_Ticks();
+
+/** @brief Começa a medir uma instrução.
+ * 
+ * @param frame Estado da instrução
+ */
+void profile_Begin(ProfileFrame* frame);
+
+/** @brief Acaba de medir uma instrução e junta os valores aos do comando, da família e da posição.
+ * 
+ * O tempo de uma instrução é descontado no 'self' da instrução que a executou, se for na mesma thread.
+ * 
+ * @param profile Apontador para o profiler
+ * @param frame Estado dado ao 'profile_Begin'
+ * @param ins Instrução executada
+ * @param hub Família que a tratou
+ */
+void profile_End(Profile* profile, ProfileFrame* frame, Instruction* ins, ProfileHub hub);
+
+/** @brief Junta os valores de um profiler aos de outro.
+ * 
+ * @param profile Profiler que recebe os valores
+ * @param other Profiler de onde vêm
+ */
+void profile_Merge(Profile* profile, Profile* other);
+
+/** @brief Escreve as tabelas dos comandos, das famílias e das posições, ordenadas pelo 'self'.
+ * 
+ * Os bytes só aparecem se o programa foi compilado com a contagem das alocações (ver o 'allocs.h'), e os
+ * contadores do processador se estiverem ligados.
+ * 
+ * @param profile Apontador para o profiler
+ * @param program Texto do programa (para mostrar cada posição)
+ * @param out Ficheiro onde se escreve
+ */
+void profile_Print(Profile* profile, char* program, FILE* out);
@@ -0,0 +1,242 @@
+/**
+ * @file Leitor da entrada numa thread à parte, que enche um buffer circular enquanto o programa corre
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "reader.h"
+
+/** Máscara que converte um indice numa posição do buffer */
+#define ReaderRingMask (ReaderRingSize - 1)
+
+
+// Esperas
+
+/** @brief Acorda o outro lado se este estiver à espera.
+ * 
+ * O indice já foi publicado antes de ler a flag (ambos com ordem total), por isso ou o outro
+ * lado vê o indice novo antes de adormecer, ou esta função vê a flag e acorda-o.
+ * 
+ * @param reader Apontador para o leitor
+ * @param waiting Flag de espera do outro lado
+ * @param cond Condição onde o outro lado espera
+ */
+void reader_p_Wake(Reader* reader, int* waiting, pthread_cond_t* cond)
+{
+    if (!__atomic_load_n(waiting, __ATOMIC_SEQ_CST))
+        return;
+    pthread_mutex_lock(&reader->lock);
+    pthread_cond_signal(cond);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+/** @brief Espera até haver dados por consumir ou a entrada acabar (chamada pelo consumidor).
+ * 
+ * @param reader Apontador para o leitor
+ * @returns Quantidade de bytes por consumir (0 no fim da entrada)
+ */
+size_t reader_p_WaitData(Reader* reader)
+{
+    size_t available = __atomic_load_n(&reader->head, __ATOMIC_ACQUIRE) - reader->tail;
+    if (available > 0)
+        return available;
+    pthread_mutex_lock(&reader->lock);
+    __atomic_store_n(&reader->consumerWaiting, 1, __ATOMIC_SEQ_CST);
+    while ((available = __atomic_load_n(&reader->head, __ATOMIC_SEQ_CST) - reader->tail) == 0 &&
+        !__atomic_load_n(&reader->eof, __ATOMIC_SEQ_CST))
+        pthread_cond_wait(&reader->data, &reader->lock);
+    __atomic_store_n(&reader->consumerWaiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&reader->lock);
+    return available;
+}
+
+/** @brief Espera até haver espaço livre no buffer ou o leitor ter de parar (chamada pelo produtor).
+ * 
+ * @param reader Apontador para o leitor
+ * @returns Quantidade de bytes livres (0 se o leitor tem de parar)
+ */
+size_t reader_p_WaitSpace(Reader* reader)
+{
+    size_t space = ReaderRingSize - (reader->head - __atomic_load_n(&reader->tail, __ATOMIC_ACQUIRE));
+    if (space > 0)
+        return space;
+    pthread_mutex_lock(&reader->lock);
+    __atomic_store_n(&reader->producerWaiting, 1, __ATOMIC_SEQ_CST);
+    while ((space = ReaderRingSize - (reader->head - __atomic_load_n(&reader->tail, __ATOMIC_SEQ_CST))) == 0 &&
+        !__atomic_load_n(&reader->stop, __ATOMIC_SEQ_CST))
+        pthread_cond_wait(&reader->space, &reader->lock);
+    __atomic_store_n(&reader->producerWaiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&reader->lock);
+    return __atomic_load_n(&reader->stop, __ATOMIC_SEQ_CST) ? 0 : space;
+}
+
+/** @brief Marca bytes como consumidos, libertando o espaço para o produtor.
+ * 
+ * @param reader Apontador para o leitor
+ * @param count Quantidade de bytes
+ */
+void reader_p_Consume(Reader* reader, size_t count)
+{
+    __atomic_store_n(&reader->tail, reader->tail + count, __ATOMIC_SEQ_CST);
+    reader_p_Wake(reader, &reader->producerWaiting, &reader->space);
+}
+
+
+// Produtor
+
+/** @brief Função principal da thread que lê: enche o buffer até a entrada acabar.
+ * 
+ * A thread só pode ser cancelada dentro do 'read' (para o 'reader_Dispose' não ficar
+ * à espera de uma entrada que pode nunca chegar).
+ * 
+ * @param args Apontador para o leitor
+ * @returns NULL
+ */
+void* reader_p_Thread(void* args)
+{
+    Reader* reader = (Reader*)args;
+    int state;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+    size_t space;
+    while ((space = reader_p_WaitSpace(reader)) > 0)
+    {
+        // Só se escreve até ao fim do buffer; o resto fica para a volta seguinte
+        size_t start = reader->head & ReaderRingMask;
+        size_t count = ReaderRingSize - start;
+        if (count > space) count = space;
+        if (count > ReaderChunkSize) count = ReaderChunkSize;
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &state);
+        ssize_t got = read(reader->fd, reader->ring + start, count);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            break;
+        __atomic_store_n(&reader->head, reader->head + got, __ATOMIC_SEQ_CST);
+        reader_p_Wake(reader, &reader->consumerWaiting, &reader->data);
+    }
+    // O fim é sempre sinalizado (o consumidor pode ter começado a esperar depois da flag ser lida)
+    pthread_mutex_lock(&reader->lock);
+    __atomic_store_n(&reader->eof, 1, __ATOMIC_SEQ_CST);
+    pthread_cond_signal(&reader->data);
+    pthread_mutex_unlock(&reader->lock);
+    return NULL;
+}
+
+
+// Leitor
+
+/** @brief Cria um leitor e começa logo a ler numa thread à parte.
+ * 
+ * @warning O descritor passa a ser lido só pelo leitor (não se pode usar o FILE correspondente).
+ * @warning O novo leitor é criado com o "malloc", logo tem que ser libertado depois usando a função 'reader_Dispose'.
+ * @param fd Descritor de onde se lê
+ * @returns Novo leitor
+ */
+Reader* reader_Create(int fd)
+{
+    Reader* reader = calloc(1, sizeof(Reader));
+    reader->ring = malloc(ReaderRingSize);
+    reader->fd = fd;
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->data, NULL);
+    pthread_cond_init(&reader->space, NULL);
+    pthread_create(&reader->thread, NULL, reader_p_Thread, reader);
+    return reader;
+}
+
+/** @brief Pára a thread e liberta o leitor.
+ * 
+ * @param reader Apontador para o leitor
+ */
+void reader_Dispose(Reader* reader)
+{
+    pthread_mutex_lock(&reader->lock);
+    __atomic_store_n(&reader->stop, 1, __ATOMIC_SEQ_CST);
+    pthread_cond_signal(&reader->space);
+    pthread_mutex_unlock(&reader->lock);
+    // Se a thread estiver presa no 'read', é cancelada
+    pthread_cancel(reader->thread);
+    pthread_join(reader->thread, NULL);
+    pthread_mutex_destroy(&reader->lock);
+    pthread_cond_destroy(&reader->data);
+    pthread_cond_destroy(&reader->space);
+    free(reader->ring);
+    free(reader);
+}
+
+/** @brief Copia bytes do buffer até ao fim da entrada, ou até a um '\n' (inclusive).
+ * 
+ * @param reader Apontador para o leitor
+ * @param untilNewLine 1 para parar no primeiro '\n'
+ * @param size Out: Quantidade de bytes copiados
+ * @returns NULL (se não havia nada) ou os bytes, com um '\0' no final
+ */
+char* reader_p_Take(Reader* reader, int untilNewLine, int* size)
+{
+    int capacity = ReaderLineSize, length = 0;
+    char* buffer = malloc(capacity + 1);
+    size_t available;
+    while ((available = reader_p_WaitData(reader)) > 0)
+    {
+        // Só se lê até ao fim do buffer; o resto fica para a volta seguinte
+        size_t start = reader->tail & ReaderRingMask;
+        size_t count = ReaderRingSize - start;
+        if (count > available) count = available;
+        char* newLine = untilNewLine ? memchr(reader->ring + start, '\n', count) : NULL;
+        if (newLine != NULL)
+            count = newLine - (reader->ring + start) + 1;
+        if (length + (int)count > capacity)
+        {
+            while (length + (int)count > capacity)
+                capacity *= 2;
+            buffer = realloc(buffer, capacity + 1);
+        }
+        memcpy(buffer + length, reader->ring + start, count);
+        length += count;
+        reader_p_Consume(reader, count);
+        if (newLine != NULL)
+            break;
+    }
+    *size = length;
+    if (length == 0)
+    {
+        free(buffer);
+        return NULL;
+    }
+    buffer[length] = '\0';
+    return buffer;
+}
+
+/** @brief Obtém a próxima linha (sem o '\n'), esperando por ela se ainda não foi lida.
+ * 
+ * @param reader Apontador para o leitor
+ * @param size Out: O tamanho da string
+ * @returns NULL (no fim da entrada) ou a linha
+ */
+char* reader_GetLine(Reader* reader, int* size)
+{
+    char* line = reader_p_Take(reader, 1, size);
+    if (line == NULL)
+        return NULL;
+    // Remove o '\n' no final
+    if (line[*size - 1] == '\n')
+        line[--*size] = '\0';
+    return realloc(line, *size + 1);
+}
+
+/** @brief Obtém tudo o que falta da entrada, esperando até esta acabar.
+ * 
+ * @param reader Apontador para o leitor
+ * @param size Out: O tamanho da string
+ * @returns NULL (se não faltar nada) ou as linhas
+ */
+char* reader_GetAll(Reader* reader, int* size)
+{
+    char* all = reader_p_Take(reader, 0, size);
+    return (all != NULL) ? realloc(all, *size + 1) : NULL;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file Leitor da entrada numa thread à parte, que enche um buffer circular enquanto o programa corre
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stddef.h>
+
+/** Tamanho do buffer circular (tem que ser uma potência de 2) */
+#define ReaderRingSize (1 << 20)
+/** Quantidade máxima de bytes pedidos de cada vez ao sistema */
+#define ReaderChunkSize (1 << 16)
+/** Tamanho inicial do buffer de uma linha */
+#define ReaderLineSize 256
+
+/**
+ * Buffer circular com um só produtor (a thread que lê) e um só consumidor (o 'l' e o 't').
+ * 
+ * O head e o tail só crescem; a posição no buffer é o valor com a máscara do tamanho.
+ * Cada lado só escreve o seu indice, por isso nenhum precisa de locks para trocar dados.
+ * O mutex e as condições só são usados para adormecer quando o buffer está vazio ou cheio.
+ */
+typedef struct ReaderT
+{
+    char* ring;                 /*!< Buffer circular com 'ReaderRingSize' bytes */
+    size_t head;                /*!< Total de bytes escritos (só o produtor escreve) */
+    size_t tail;                /*!< Total de bytes consumidos (só o consumidor escreve) */
+    int eof;                    /*!< 1 quando a entrada acabou (depois do último head) */
+    int stop;                   /*!< 1 quando o leitor vai ser libertado */
+    int consumerWaiting;        /*!< 1 enquanto o consumidor espera por dados */
+    int producerWaiting;        /*!< 1 enquanto o produtor espera por espaço */
+    int fd;                     /*!< Descritor de onde se lê */
+    pthread_t thread;           /*!< Thread que lê */
+    pthread_mutex_t lock;       /*!< Só protege as esperas */
+    pthread_cond_t data;        /*!< Sinal de que há dados novos (ou o fim da entrada) */
+    pthread_cond_t space;       /*!< Sinal de que há espaço livre (ou que o leitor vai parar) */
+} Reader;
+
+
+/** @brief Cria um leitor e começa logo a ler numa thread à parte.
+ * 
+ * @warning O descritor passa a ser lido só pelo leitor (não se pode usar o FILE correspondente).
+ * @warning O novo leitor é criado com o "malloc", logo tem que ser libertado depois usando a função 'reader_Dispose'.
+ * @param fd Descritor de onde se lê
+ * @returns Novo leitor
+ */
+Reader* reader_Create(int fd);
+
+/** @brief Pára a thread e liberta o leitor.
+ * 
+ * @param reader Apontador para o leitor
+ */
+void reader_Dispose(Reader* reader);
+
+/** @brief Obtém a próxima linha (sem o '\n'), esperando por ela se ainda não foi lida.
+ * 
+ * @param reader Apontador para o leitor
+ * @param size Out: O tamanho da string
+ * @returns NULL (no fim da entrada) ou a linha
+ */
+char* reader_GetLine(Reader* reader, int* size);
+
+/** @brief Obtém tudo o que falta da entrada, esperando até esta acabar.
+ * 
+ * @param reader Apontador para o leitor
+ * @param size Out: O tamanho da string
+ * @returns NULL (se não faltar nada) ou as linhas
+ */
+char* reader_GetAll(Reader* reader, int* size);
@@ -0,0 +1,669 @@
+/**
+ * @file Algoritmos de ordenação de items, chars e longs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+#include "sort.h"
+#include "utils.h"
+
+/**
+ * Elemento usado pelo pdqsort: o item, a chave já convertida (quando são todos números) e o indice original
+ */
+typedef struct SortEntryT
+{
+    Item* item;     /*!< Apontador para o item (ou para a chave dele) */
+    double key;     /*!< Valor do item (só é usado se forem todos números) */
+    int index;      /*!< Indice original, desempata items iguais para a ordenação ser estável */
+} SortEntry;
+
+/** Função que diz se um elemento vem antes de outro */
+typedef int (*SortLess)(SortEntry* a, SortEntry* b);
+
+/**
+ * Elemento usado pelo radix sort
+ */
+typedef struct SortKeyT
+{
+    unsigned long key;  /*!< Chave com o bit do sinal trocado, para a ordem sem sinal ser a ordem com sinal */
+    Item* item;         /*!< Apontador para o item */
+} SortKey;
+
+
+
+// Comparações
+
+/** @brief Compara dois items pela ordem do 'item_Compare', desempatando pelo indice.
+ *
+ * @param a Elemento A
+ * @param b Elemento B
+ * @returns 1 se A vem antes de B
+ */
+int sort_p_LessItem(SortEntry* a, SortEntry* b)
+{
+    int c = item_Compare(a->item, b->item);
+    return c < 0 || (c == 0 && a->index < b->index);
+}
+
+/** @brief Compara dois números pela chave já convertida, desempatando pelo indice.
+ *
+ * @param a Elemento A
+ * @param b Elemento B
+ * @returns 1 se A vem antes de B
+ */
+int sort_p_LessKey(SortEntry* a, SortEntry* b)
+{
+    return a->key < b->key || (!(b->key < a->key) && a->index < b->index);
+}
+
+/** @brief Compara duas strings pelo texto, desempatando pelo indice.
+ *
+ * @param a Elemento A
+ * @param b Elemento B
+ * @returns 1 se A vem antes de B
+ */
+int sort_p_LessString(SortEntry* a, SortEntry* b)
+{
+    int c = utils_StringCompare((char*)a->item->pointer, (char*)b->item->pointer);
+    return c < 0 || (c == 0 && a->index < b->index);
+}
+
+
+
+// pdqsort
+
+/** @brief Troca dois elementos.
+ *
+ * @param a Elemento A
+ * @param b Elemento B
+ */
+void sort_p_Swap(SortEntry* a, SortEntry* b)
+{
+    SortEntry t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/** @brief Ordena 3 elementos (fica a mediana no do meio).
+ *
+ * @param a Elemento A
+ * @param b Elemento B
+ * @param c Elemento C
+ * @param less Função de comparação
+ */
+void sort_p_Sort3(SortEntry* a, SortEntry* b, SortEntry* c, SortLess less)
+{
+    if (less(b, a)) sort_p_Swap(a, b);
+    if (less(c, b)) sort_p_Swap(b, c);
+    if (less(b, a)) sort_p_Swap(a, b);
+}
+
+/** @brief Ordena uma parte da array por inserção.
+ *
+ * @param a Array
+ * @param lo Indice do inicio
+ * @param hi Indice do fim (exclusivo)
+ * @param less Função de comparação
+ */
+void sort_p_Insertion(SortEntry* a, int lo, int hi, SortLess less)
+{
+    for (int i = lo + 1; i < hi; i++)
+    {
+        SortEntry t = a[i];
+        int j = i;
+        while (j > lo && less(&t, &a[j - 1]))
+        {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = t;
+    }
+}
+
+/** @brief Tenta ordenar uma parte da array por inserção, mas desiste se tiver que mover muitos elementos.
+ *
+ * @param a Array
+ * @param lo Indice do inicio
+ * @param hi Indice do fim (exclusivo)
+ * @param less Função de comparação
+ * @returns 1 se a parte ficou ordenada
+ */
+int sort_p_PartialInsertion(SortEntry* a, int lo, int hi, SortLess less)
+{
+    int moves = 0;
+    for (int i = lo + 1; i < hi; i++)
+    {
+        SortEntry t = a[i];
+        int j = i;
+        while (j > lo && less(&t, &a[j - 1]))
+        {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = t;
+        moves += i - j;
+        if (moves > 8)
+            return i + 1 == hi;
+    }
+    return 1;
+}
+
+/** @brief Desce um elemento na heap.
+ *
+ * @param a Inicio da heap
+ * @param i Indice do elemento
+ * @param n Tamanho da heap
+ * @param less Função de comparação
+ */
+void sort_p_SiftDown(SortEntry* a, int i, int n, SortLess less)
+{
+    while (2 * i + 1 < n)
+    {
+        int child = 2 * i + 1;
+        if (child + 1 < n && less(&a[child], &a[child + 1]))
+            child++;
+        if (!less(&a[i], &a[child]))
+            return;
+        sort_p_Swap(&a[i], &a[child]);
+        i = child;
+    }
+}
+
+/** @brief Ordena uma parte da array com heapsort (usado quando as partições ficam muito desequilibradas).
+ *
+ * @param a Array
+ * @param lo Indice do inicio
+ * @param hi Indice do fim (exclusivo)
+ * @param less Função de comparação
+ */
+void sort_p_Heap(SortEntry* a, int lo, int hi, SortLess less)
+{
+    SortEntry* heap = a + lo;
+    int n = hi - lo;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sort_p_SiftDown(heap, i, n, less);
+    for (int i = n - 1; i > 0; i--)
+    {
+        sort_p_Swap(&heap[0], &heap[i]);
+        sort_p_SiftDown(heap, 0, i, less);
+    }
+}
+
+/** @brief Divide uma parte da array à volta do pivot (que está no inicio).
+ *
+ * Os ciclos verificam sempre os limites, para uma comparação inconsistente não sair da array.
+ *
+ * @param a Array
+ * @param lo Indice do inicio
+ * @param hi Indice do fim (exclusivo)
+ * @param less Função de comparação
+ * @param already Out: 1 se a parte já estava dividida
+ * @returns Posição final do pivot
+ */
+int sort_p_Partition(SortEntry* a, int lo, int hi, SortLess less, int* already)
+{
+    SortEntry pivot = a[lo];
+    int first = lo + 1, last = hi - 1;
+    while (first < hi && less(&a[first], &pivot))
+        first++;
+    while (last >= first && !less(&a[last], &pivot))
+        last--;
+    *already = first >= last;
+    while (first < last)
+    {
+        sort_p_Swap(&a[first], &a[last]);
+        first++;
+        while (first < hi && less(&a[first], &pivot))
+            first++;
+        last--;
+        while (last >= first && !less(&a[last], &pivot))
+            last--;
+    }
+    int pivotPos = first - 1;
+    a[lo] = a[pivotPos];
+    a[pivotPos] = pivot;
+    return pivotPos;
+}
+
+/** @brief Ciclo principal do pdqsort (pattern-defeating quicksort).
+ *
+ * Como o indice desempata todos os elementos, não há elementos iguais e não é preciso
+ * a divisão especial para muitos elementos iguais ao pivot.
+ *
+ * @param a Array
+ * @param lo Indice do inicio
+ * @param hi Indice do fim (exclusivo)
+ * @param less Função de comparação
+ * @param badAllowed Quantas divisões desequilibradas ainda são aceites antes de mudar para heapsort
+ */
+void sort_p_Pdq(SortEntry* a, int lo, int hi, SortLess less, int badAllowed)
+{
+    while (1)
+    {
+        int size = hi - lo, half = size / 2;
+        if (size < SortInsertionSize)
+        {
+            sort_p_Insertion(a, lo, hi, less);
+            return;
+        }
+        if (size > 128) // Pseudo-mediana de 9 (ninther)
+        {
+            sort_p_Sort3(&a[lo], &a[lo + half], &a[hi - 1], less);
+            sort_p_Sort3(&a[lo + 1], &a[lo + half - 1], &a[hi - 2], less);
+            sort_p_Sort3(&a[lo + 2], &a[lo + half + 1], &a[hi - 3], less);
+            sort_p_Sort3(&a[lo + half - 1], &a[lo + half], &a[lo + half + 1], less);
+            sort_p_Swap(&a[lo], &a[lo + half]);
+        }
+        else sort_p_Sort3(&a[lo + half], &a[lo], &a[hi - 1], less);
+
+        int already;
+        int pivotPos = sort_p_Partition(a, lo, hi, less, &already);
+        int lsize = pivotPos - lo, rsize = hi - pivotPos - 1;
+        if (lsize < size / 8 || rsize < size / 8)
+        {
+            if (--badAllowed == 0)
+            {
+                sort_p_Heap(a, lo, hi, less);
+                return;
+            }
+            // Baralha alguns elementos para estragar o padrão que causou a má divisão
+            if (lsize >= SortInsertionSize)
+            {
+                sort_p_Swap(&a[lo], &a[lo + lsize / 4]);
+                sort_p_Swap(&a[pivotPos - 1], &a[pivotPos - lsize / 4]);
+            }
+            if (rsize >= SortInsertionSize)
+            {
+                sort_p_Swap(&a[pivotPos + 1], &a[pivotPos + 1 + rsize / 4]);
+                sort_p_Swap(&a[hi - 1], &a[hi - rsize / 4]);
+            }
+        }
+        else if (already && sort_p_PartialInsertion(a, lo, pivotPos, less) &&
+            sort_p_PartialInsertion(a, pivotPos + 1, hi, less))
+            return;
+        // Recursão na parte mais pequena, ciclo na maior
+        if (lsize < rsize)
+        {
+            sort_p_Pdq(a, lo, pivotPos, less, badAllowed);
+            lo = pivotPos + 1;
+        }
+        else
+        {
+            sort_p_Pdq(a, pivotPos + 1, hi, less, badAllowed);
+            hi = pivotPos;
+        }
+    }
+}
+
+// Merge sort paralelo
+
+/**
+ * Trabalho do merge sort paralelo: cada parte é ordenada com pdqsort, e depois as partes são juntadas duas a duas
+ */
+typedef struct SortMergeJobT
+{
+    SortEntry* from;    /*!< Array com as partes ordenadas */
+    SortEntry* to;      /*!< Array onde se escrevem as partes juntadas */
+    int* bounds;        /*!< Inicio de cada parte (com o fim no ultimo indice) */
+    int parts;          /*!< Quantidade de partes */
+    SortLess less;      /*!< Função de comparação */
+} SortMergeJob;
+
+/** @brief Calcula o logaritmo de base 2 de um número (arredondado para baixo).
+ *
+ * @param n Número
+ * @returns Logaritmo
+ */
+int sort_p_Log(int n)
+{
+    int log = 0;
+    for (int i = n; i > 1; i >>= 1)
+        log++;
+    return log;
+}
+
+/** @brief Ordena uma parte com pdqsort.
+ *
+ * @param context Apontador para o trabalho
+ * @param part Indice da parte
+ * @param worker Indice da thread (não é usado)
+ */
+void sort_p_SortPart(void* context, int part, int worker)
+{
+    (void)worker;
+    SortMergeJob* job = (SortMergeJob*)context;
+    int lo = job->bounds[part], hi = job->bounds[part + 1];
+    sort_p_Pdq(job->from, lo, hi, job->less, sort_p_Log(hi - lo) + 1);
+}
+
+/** @brief Junta as partes 2 * pair e 2 * pair + 1 (se existir) na outra array.
+ *
+ * Em caso de empate fica primeiro o da esquerda, mas como o indice desempata tudo não há empates.
+ *
+ * @param context Apontador para o trabalho
+ * @param pair Indice do par
+ * @param worker Indice da thread (não é usado)
+ */
+void sort_p_MergePair(void* context, int pair, int worker)
+{
+    (void)worker;
+    SortMergeJob* job = (SortMergeJob*)context;
+    int lo = job->bounds[2 * pair], mid = job->bounds[2 * pair + 1 < job->parts ? 2 * pair + 1 : job->parts];
+    int hi = job->bounds[2 * pair + 2 <= job->parts ? 2 * pair + 2 : job->parts];
+    int i = lo, j = mid, k = lo;
+    while (i < mid && j < hi)
+        job->to[k++] = job->less(&job->from[j], &job->from[i]) ? job->from[j++] : job->from[i++];
+    while (i < mid)
+        job->to[k++] = job->from[i++];
+    while (j < hi)
+        job->to[k++] = job->from[j++];
+}
+
+/** @brief Ordena os elementos com merge sort paralelo (pdqsort em cada parte e junções em paralelo).
+ *
+ * O resultado é igual ao do pdqsort em série, porque o indice original desempata todos os elementos.
+ *
+ * @param pool Apontador para a pool
+ * @param entries Array com os elementos
+ * @param n Quantidade de elementos
+ * @param less Função de comparação
+ */
+void sort_p_MergeParallel(Pool* pool, SortEntry* entries, int n, SortLess less)
+{
+    SortMergeJob job;
+    job.parts = pool->count * SortPartsPerThread;
+    job.bounds = malloc((job.parts + 1) * sizeof(int));
+    for (int i = 0; i <= job.parts; i++)
+        job.bounds[i] = (int)((long)n * i / job.parts);
+    job.from = entries;
+    job.to = malloc(n * sizeof(SortEntry));
+    job.less = less;
+    pool_Run(pool, job.parts, sort_p_SortPart, &job);
+    while (job.parts > 1)
+    {
+        int pairs = (job.parts + 1) / 2;
+        pool_Run(pool, pairs, sort_p_MergePair, &job);
+        // As partes juntadas passam a ser as novas partes
+        for (int i = 0; i < pairs; i++)
+            job.bounds[i] = job.bounds[2 * i];
+        job.bounds[pairs] = n;
+        job.parts = pairs;
+        SortEntry* t = job.from;
+        job.from = job.to;
+        job.to = t;
+    }
+    if (job.from != entries)
+    {
+        memcpy(entries, job.from, n * sizeof(SortEntry));
+        free(job.from);
+    }
+    else free(job.to);
+    free(job.bounds);
+}
+
+/** @brief Ordena items pelas chaves com pdqsort.
+ *
+ * @param keys Array com as chaves
+ * @param values Array com os items a ordenar (pode ser a mesma das chaves)
+ * @param n Quantidade de items
+ * @param less Função de comparação ('sort_p_LessKey' se forem todos números)
+ */
+void sort_p_Mixed(Item** keys, Item** values, int n, SortLess less)
+{
+    SortEntry* entries = malloc(n * sizeof(SortEntry));
+    for (int i = 0; i < n; i++)
+    {
+        entries[i].item = keys[i];
+        entries[i].key = (less == sort_p_LessKey) ? i_ToDouble(keys[i]) : 0;
+        entries[i].index = i;
+    }
+    Pool* pool = pool_Default();
+    if (pool != NULL && n >= SortParallelMinSize)
+        sort_p_MergeParallel(pool, entries, n, less);
+    else sort_p_Pdq(entries, 0, n, less, sort_p_Log(n) + 1);
+    Item** original = malloc(n * sizeof(Item*));
+    memcpy(original, values, n * sizeof(Item*));
+    for (int i = 0; i < n; i++)
+        values[i] = original[entries[i].index];
+    free(original);
+    free(entries);
+}
+
+
+
+// Radix e counting sort
+
+/**
+ * Trabalho do radix sort paralelo: cada thread conta e distribui uma parte seguida da array
+ */
+typedef struct SortRadixJobT
+{
+    SortKey* from;      /*!< Array de onde se lê */
+    SortKey* to;        /*!< Array onde se escreve */
+    int n;              /*!< Quantidade de elementos */
+    int parts;          /*!< Quantidade de partes */
+    int shift;          /*!< Bits a saltar na chave nesta passagem */
+    int (*count)[256];  /*!< Contagem de cada byte em cada parte (depois passa a ser a posição onde escrever) */
+} SortRadixJob;
+
+/** @brief Conta os bytes de uma parte, na passagem atual.
+ *
+ * @param context Apontador para o trabalho
+ * @param part Indice da parte
+ * @param worker Indice da thread (não é usado)
+ */
+void sort_p_RadixCount(void* context, int part, int worker)
+{
+    (void)worker;
+    SortRadixJob* job = (SortRadixJob*)context;
+    int lo = (int)((long)job->n * part / job->parts), hi = (int)((long)job->n * (part + 1) / job->parts);
+    int* count = job->count[part];
+    memset(count, 0, 256 * sizeof(int));
+    for (int i = lo; i < hi; i++)
+        count[(job->from[i].key >> job->shift) & 0xFF]++;
+}
+
+/** @brief Distribui os elementos de uma parte pelas posições já calculadas.
+ *
+ * As partes escrevem em posições diferentes, e pela ordem original, então a ordenação continua estável.
+ *
+ * @param context Apontador para o trabalho
+ * @param part Indice da parte
+ * @param worker Indice da thread (não é usado)
+ */
+void sort_p_RadixScatter(void* context, int part, int worker)
+{
+    (void)worker;
+    SortRadixJob* job = (SortRadixJob*)context;
+    int lo = (int)((long)job->n * part / job->parts), hi = (int)((long)job->n * (part + 1) / job->parts);
+    int* pos = job->count[part];
+    for (int i = lo; i < hi; i++)
+        job->to[pos[(job->from[i].key >> job->shift) & 0xFF]++] = job->from[i];
+}
+
+/** @brief Ordena as chaves com radix sort (LSD, 8 bits de cada vez), dividido pelas threads da pool.
+ *
+ * @param pool Apontador para a pool
+ * @param keys Array com as chaves
+ * @param buffer Array auxiliar com o mesmo tamanho
+ * @param n Quantidade de elementos
+ * @returns A array (keys ou buffer) que ficou com o resultado
+ */
+SortKey* sort_p_RadixParallel(Pool* pool, SortKey* keys, SortKey* buffer, int n)
+{
+    SortRadixJob job;
+    job.n = n;
+    job.parts = pool->count;
+    job.count = malloc(job.parts * sizeof(*job.count));
+    job.from = keys;
+    job.to = buffer;
+    for (job.shift = 0; job.shift < 64; job.shift += 8)
+    {
+        pool_Run(pool, job.parts, sort_p_RadixCount, &job);
+        // A posição de cada byte em cada parte vem depois dos bytes menores e das partes anteriores
+        int pos = 0, same = 0;
+        for (int d = 0; d < 256; d++)
+        {
+            int start = pos;
+            for (int p = 0; p < job.parts; p++)
+            {
+                int c = job.count[p][d];
+                job.count[p][d] = pos;
+                pos += c;
+            }
+            // Se todos tiverem o mesmo byte, esta passagem não muda nada
+            if (pos - start == n)
+                same = 1;
+        }
+        if (same)
+            continue;
+        pool_Run(pool, job.parts, sort_p_RadixScatter, &job);
+        SortKey* t = job.from;
+        job.from = job.to;
+        job.to = t;
+    }
+    free(job.count);
+    return job.from;
+}
+
+/** @brief Ordena as chaves com radix sort (LSD, 8 bits de cada vez).
+ *
+ * @param keys Array com as chaves
+ * @param buffer Array auxiliar com o mesmo tamanho
+ * @param n Quantidade de elementos
+ * @returns A array (keys ou buffer) que ficou com o resultado
+ */
+SortKey* sort_p_Radix(SortKey* keys, SortKey* buffer, int n)
+{
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        int count[257] = { 0 };
+        for (int i = 0; i < n; i++)
+            count[((keys[i].key >> shift) & 0xFF) + 1]++;
+        // Se todos tiverem o mesmo byte, esta passagem não muda nada
+        if (count[((keys[0].key >> shift) & 0xFF) + 1] == n)
+            continue;
+        for (int i = 0; i < 256; i++)
+            count[i + 1] += count[i];
+        for (int i = 0; i < n; i++)
+            buffer[count[(keys[i].key >> shift) & 0xFF]++] = keys[i];
+        SortKey* t = keys;
+        keys = buffer;
+        buffer = t;
+    }
+    return keys;
+}
+
+/** @brief Ordena items com chaves que são todas longs com radix sort.
+ *
+ * @param array Array com as chaves
+ * @param values Array com os items a ordenar (pode ser a mesma das chaves)
+ * @param n Quantidade de items
+ */
+void sort_p_Longs(Item** array, Item** values, int n)
+{
+    SortKey* keys = malloc(n * sizeof(SortKey));
+    SortKey* buffer = malloc(n * sizeof(SortKey));
+    for (int i = 0; i < n; i++)
+    {
+        keys[i].key = (unsigned long)*(long*)array[i]->pointer ^ (1UL << 63);
+        keys[i].item = values[i];
+    }
+    Pool* pool = pool_Default();
+    SortKey* sorted = (pool != NULL && n >= SortParallelMinSize) ?
+        sort_p_RadixParallel(pool, keys, buffer, n) : sort_p_Radix(keys, buffer, n);
+    for (int i = 0; i < n; i++)
+        values[i] = sorted[i].item;
+    free(keys);
+    free(buffer);
+}
+
+/** @brief Ordena items com chaves que são todas chars com counting sort.
+ *
+ * @param array Array com as chaves
+ * @param values Array com os items a ordenar (pode ser a mesma das chaves)
+ * @param n Quantidade de items
+ */
+void sort_p_CharItems(Item** array, Item** values, int n)
+{
+    int count[257] = { 0 };
+    Item** buffer = malloc(n * sizeof(Item*));
+    // O xor com 0x80 faz com que a ordem sem sinal seja a ordem dos chars com sinal
+    for (int i = 0; i < n; i++)
+        count[((unsigned char)*(char*)array[i]->pointer ^ 0x80) + 1]++;
+    for (int i = 0; i < 256; i++)
+        count[i + 1] += count[i];
+    for (int i = 0; i < n; i++)
+        buffer[count[(unsigned char)*(char*)array[i]->pointer ^ 0x80]++] = values[i];
+    memcpy(values, buffer, n * sizeof(Item*));
+    free(buffer);
+}
+
+/** @brief Ordena os chars de uma string (counting sort).
+ *
+ * @param string Apontador para a string
+ * @param size Tamanho da string
+ */
+void sort_Chars(char* string, int size)
+{
+    int count[256] = { 0 };
+    for (int i = 0; i < size; i++)
+        count[(unsigned char)string[i] ^ 0x80]++;
+    int pos = 0;
+    for (int i = 0; i < 256; i++)
+    {
+        memset(string + pos, (char)(i ^ 0x80), count[i]);
+        pos += count[i];
+    }
+}
+
+
+
+/** @brief Ordena items pelas chaves, escolhendo o algoritmo pelos tipos das chaves.
+ *
+ * @param keys Array com as chaves
+ * @param values Array com os items a ordenar (pode ser a mesma das chaves)
+ * @param n Quantidade de items
+ */
+void sort_p_ByKeys(Item** keys, Item** values, int n)
+{
+    if (n < 2)
+        return;
+    int types = 0;
+    for (int i = 0; i < n; i++)
+        types |= keys[i]->type;
+    if (types == TLong)
+        sort_p_Longs(keys, values, n);
+    else if (types == TChar)
+        sort_p_CharItems(keys, values, n);
+    else if (types == TString)
+        sort_p_Mixed(keys, values, n, sort_p_LessString);
+    else sort_p_Mixed(keys, values, n, ((types & ~IT_Num) == 0) ? sort_p_LessKey : sort_p_LessItem);
+}
+
+/** @brief Ordena uma array de items (ordenação estável).
+ *
+ * Escolhe o algoritmo pelos tipos: radix sort se forem todos longs, counting sort se
+ * forem todos chars, e pdqsort (com o indice original a desempatar) para o resto.
+ *
+ * @param array Array de apontadores para os items
+ * @param n Quantidade de items
+ */
+void sort_Items(Item** array, int n)
+{
+    sort_p_ByKeys(array, array, n);
+}
+
+/** @brief Ordena uma array de items pelas chaves já calculadas (ordenação estável).
+ *
+ * @param array Array de apontadores para os items
+ * @param keys Chave de cada item (não é alterada)
+ * @param n Quantidade de items
+ */
+void sort_ItemsByKey(Item** array, Item** keys, int n)
+{
+    sort_p_ByKeys(keys, array, n);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file Algoritmos de ordenação de items, chars e longs
+ */
+
+#pragma once
+
+#include "item.h"
+
+/** Abaixo deste tamanho as partições são ordenadas por inserção */
+#define SortInsertionSize 24
+/** A partir deste tamanho a ordenação é dividida pelas threads (se o modo paralelo estiver ligado) */
+#define SortParallelMinSize 65536
+/** Quantidade de partes por thread no merge sort paralelo */
+#define SortPartsPerThread 4
+
+
+/** @brief Ordena uma array de items (ordenação estável).
+ *
+ * Escolhe o algoritmo pelos tipos: radix sort se forem todos longs, counting sort se
+ * forem todos chars, e pdqsort (com o indice original a desempatar) para o resto.
+ * Com o modo paralelo ligado e arrays grandes, o radix sort e o pdqsort são divididos
+ * pelas threads, com o mesmo resultado que em série.
+ *
+ * @param array Array de apontadores para os items
+ * @param n Quantidade de items
+ */
+void sort_Items(Item** array, int n);
+
+/** @brief Ordena uma array de items pelas chaves já calculadas (ordenação estável).
+ *
+ * Os tipos das chaves escolhem o algoritmo, como no 'sort_Items' (strings têm uma comparação própria).
+ *
+ * @param array Array de apontadores para os items
+ * @param keys Chave de cada item (não é alterada)
+ * @param n Quantidade de items
+ */
+void sort_ItemsByKey(Item** array, Item** keys, int n);
+
+/** @brief Ordena os chars de uma string (counting sort).
+ *
+ * @param string Apontador para a string
+ * @param size Tamanho da string
+ */
+void sort_Chars(char* string, int size);
@@ -20,6 +20,17 @@ void stack_AssureCapacity(Stack* stack)
         stack_IncreaseSize(stack, stack->capacity);
 }
 
+/** @brief Garante que o stack tem espaço para mais n items, para serem guardados sem verificar a capacidade.
+ * 
+ * @param stack Apontador para o stack
+ * @param n Quantidade de items
+ */
+void stack_Reserve(Stack* stack, int n)
+{
+    if (stack->pointer + n + 1 >= stack->capacity)
+        stack_IncreaseSize(stack, (n < stack->capacity) ? stack->capacity : n + 1);
+}
+
 
 /** @brief Cria um stack.
  * 
@@ -59,13 +70,15 @@ void stack_IncreaseSize(Stack* stack, int increase)
  */
 void stack_Clear(Stack* stack)
 {
+    // Acima do topo os espaços estão sempre a NULL
     Item** array = stack->array;
-    for (int i = 0; i < stack->capacity; i++)
+    for (int i = 0; i <= stack->pointer; i++)
         if (array[i] != NULL)
         {
             item_Dispose(array[i]);
             array[i] = NULL;
         }
+    stack->pointer = -1;
 }
 
 /** @brief Limpa o stack e os items no stack.
@@ -109,12 +122,34 @@ void stack_Push(Stack* stack, Item* item)
     stack->array[stack->pointer] = item;
 }
 
-/** @brief Retira um item da stack.
+/** @brief Retira um item da stack (materializando-o se for uma vista).
  * 
  * @param stack Apontador para o stack
  * @returns Item removido
  */
 Item* stack_Pop(Stack* stack)
+{
+    Item* item = stack_PopLazy(stack);
+    return (item != NULL) ? item_Force(item) : NULL;
+}
+
+/** @brief Retorna o item no topo da stack sem o remover (materializando-o se for uma vista).
+ * 
+ * @param stack Apontador para o stack
+ * @returns Item
+ */
+Item* stack_Peek(Stack* stack)
+{
+    Item* item = stack_PeekLazy(stack);
+    return (item != NULL) ? item_Force(item) : NULL;
+}
+
+/** @brief Retira um item da stack, sem materializar as vistas.
+ * 
+ * @param stack Apontador para o stack
+ * @returns Item removido
+ */
+Item* stack_PopLazy(Stack* stack)
 {
     if (stack_IsEmpty(stack))
         return NULL;
@@ -124,12 +159,12 @@ Item* stack_Pop(Stack* stack)
     return item;
 }
 
-/** @brief Retorna o item no topo da stack sem o remover.
+/** @brief Retorna o item no topo da stack sem o remover, sem materializar as vistas.
  * 
  * @param stack Apontador para o stack
  * @returns Item
  */
-Item* stack_Peek(Stack* stack)
+Item* stack_PeekLazy(Stack* stack)
 {
     if (stack_IsEmpty(stack))
         return NULL;
@@ -176,10 +211,25 @@ List* stack_ToList(Stack* stack)
 {
     List* list = list_Create(stack->pointer + 1);
     for (int i = 0; i <= stack->pointer; i++)
-        list_Add(list, item_Copy(stack->array[i]));
+        list_Add(list, item_Force(item_Copy(stack->array[i])));
     return list;
 }
 
+/** @brief Passa os items do stack para o fim de uma lista, sem os copiar (o stack fica vazio)
+ * 
+ * @param stack Apontador para o stack
+ * @param list Apontador para a lista
+ */
+void stack_MoveToList(Stack* stack, List* list)
+{
+    for (int i = 0; i <= stack->pointer; i++)
+    {
+        list_Add(list, item_Force(stack->array[i]));
+        stack->array[i] = NULL;
+    }
+    stack->pointer = -1;
+}
+
 /** @brief Converte uma lista para um stack
  * 
  * @param stack Apontador para a lista
@@ -199,27 +249,27 @@ Stack* stack_FromList(List* list)
  * 
  * @param stack Apontador para o stack
  */
-void stack_Print(Stack* stack)
+void stack_Print(Stack* stack, FILE* out)
 {
     if (stack->pointer > -1)
         for (int i = 0; i <= stack->pointer; i++)
-            item_Print(stack->array[i]);
+            item_Print(stack->array[i], out);
 }
 
 /** @brief Imprime o stack com espaços a separar os items.
  * 
  * @param stack Apontador para o stack
  */
-void stack_PrintWS(Stack* stack)
+void stack_PrintWS(Stack* stack, FILE* out)
 {
     if (stack->pointer > 0)
         for (int i = 0; i < stack->pointer; i++)
         {
-            item_Print(stack->array[i]);
-            printf(" ");
+            item_Print(stack->array[i], out);
+            putc(' ', out);
         }
     if (stack->pointer > -1)
-        item_Print(stack->array[stack->pointer]);
+        item_Print(stack->array[stack->pointer], out);
 }
 
 
@@ -36,6 +36,13 @@ Stack* stack_Create(int initialSize);
  */
 void stack_IncreaseSize(Stack* stack, int increase);
 
+/** @brief Garante que o stack tem espaço para mais n items, para serem guardados sem verificar a capacidade.
+ * 
+ * @param stack Apontador para o stack
+ * @param n Quantidade de items
+ */
+void stack_Reserve(Stack* stack, int n);
+
 /** @brief Limpa os items no stack.
  * 
  * @param stack Apontador para o stack
@@ -70,20 +77,34 @@ int stack_Count(Stack* stack);
  */
 void stack_Push(Stack* stack, Item* item);
 
-/** @brief Retira um item da stack.
+/** @brief Retira um item da stack (materializando-o se for uma vista).
  * 
  * @param stack Apontador para o stack
  * @returns Item removido
  */
 Item* stack_Pop(Stack* stack);
 
-/** @brief Retorna o item no topo da stack sem o remover.
+/** @brief Retorna o item no topo da stack sem o remover (materializando-o se for uma vista).
  * 
  * @param stack Apontador para o stack
  * @returns Item
  */
 Item* stack_Peek(Stack* stack);
 
+/** @brief Retira um item da stack, sem materializar as vistas.
+ * 
+ * @param stack Apontador para o stack
+ * @returns Item removido
+ */
+Item* stack_PopLazy(Stack* stack);
+
+/** @brief Retorna o item no topo da stack sem o remover, sem materializar as vistas.
+ * 
+ * @param stack Apontador para o stack
+ * @returns Item
+ */
+Item* stack_PeekLazy(Stack* stack);
+
 
 /** @brief Copia um dos items na stack.
  * 
@@ -110,6 +131,13 @@ void stack_Switch(Stack* stack, int n1, int n2);
  */
 List* stack_ToList(Stack* stack);
 
+/** @brief Passa os items do stack para o fim de uma lista, sem os copiar (o stack fica vazio)
+ * 
+ * @param stack Apontador para o stack
+ * @param list Apontador para a lista
+ */
+void stack_MoveToList(Stack* stack, List* list);
+
 /** @brief Converte uma lista para um stack
  * 
  * @param stack Apontador para a lista
@@ -122,13 +150,15 @@ Stack* stack_FromList(List* list);
 /** @brief Imprime o stack.
  * 
  * @param stack Apontador para o stack
+ * @param out Ficheiro onde se escreve
  */
-void stack_Print(Stack* stack);
+void stack_Print(Stack* stack, FILE* out);
 
 /** @brief Imprime o stack com espaços a separar os items.
  * 
  * @param stack Apontador para o stack
+ * @param out Ficheiro onde se escreve
  */
-void stack_PrintWS(Stack* stack);
+void stack_PrintWS(Stack* stack, FILE* out);
 
 
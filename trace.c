@@ -0,0 +1,199 @@
+/**
+ * @file Tracer: guarda cada instrução executada num buffer circular binário, para depois ser convertida pelo trace.py
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "profile.h"
+#include "trace.h"
+
+/** Identificação do formato, no inicio do ficheiro */
+#define TraceMagic "GSTRACE1"
+
+// Profundidade da instrução atual, e o tracer onde esta thread escreve, com o seu número e buffer lá dentro
+static __thread int trace_p_depth, trace_p_thread;
+static __thread Trace* trace_p_owner;
+static __thread TraceRing* trace_p_ring;
+
+
+/** @brief Lê o relógio em nanosegundos.
+ * 
+ * @returns Nanosegundos
+ */
+long trace_p_Ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/** @brief Cria um tracer vazio.
+ * 
+ * @warning O novo tracer é criado com o "malloc", logo tem que ser libertado depois usando a função 'trace_Dispose'.
+ * @param capacity Quantidade de eventos guardados por thread (arredondada para cima para uma potência de 2)
+ * @returns Novo tracer
+ */
+Trace* trace_Create(uint64_t capacity)
+{
+    Trace* trace = calloc(1, sizeof(Trace));
+    trace->capacity = 1;
+    while (trace->capacity < capacity)
+        trace->capacity *= 2;
+    trace->startNs = trace_p_Ns();
+    trace->startTicks = profile_Ticks();
+    return trace;
+}
+
+/** @brief Liberta o tracer.
+ * 
+ * @param trace Apontador para o tracer
+ */
+void trace_Dispose(Trace* trace)
+{
+    for (int i = 0; i < trace->threads && i < TraceMaxThreads; i++)
+    {
+        free(trace->rings[i]->events);
+        free(trace->rings[i]);
+    }
+    free(trace);
+}
+
+/** @brief Dá o buffer da thread atual, criando-o se é a primeira vez que ela escreve neste tracer.
+ * 
+ * @param trace Apontador para o tracer
+ * @returns Buffer (NULL se já há 'TraceMaxThreads' threads)
+ */
+TraceRing* trace_p_Ring(Trace* trace)
+{
+    if (trace_p_owner == trace)
+        return trace_p_ring;
+    trace_p_owner = trace;
+    trace_p_thread = __atomic_fetch_add(&trace->threads, 1, __ATOMIC_RELAXED);
+    trace_p_ring = NULL;
+    if (trace_p_thread < TraceMaxThreads)
+    {
+        trace_p_ring = calloc(1, sizeof(TraceRing));
+        trace_p_ring->events = malloc(trace->capacity * sizeof(TraceEvent));
+        trace->rings[trace_p_thread] = trace_p_ring;
+    }
+    return trace_p_ring;
+}
+
+/** @brief Codifica o tipo de um item em 4 bits.
+ * 
+ * @param item Apontador para o item (ou NULL)
+ * @returns 0 se não há item, senão o indice do bit do tipo + 1
+ */
+uint8_t trace_p_Type(Item* item)
+{
+    if (item == NULL || item->type == 0)
+        return 0;
+    return (uint8_t)(__builtin_ctz(item->type) + 1) & 0xF;
+}
+
+/** @brief Começa uma instrução.
+ * 
+ * @param span Estado da instrução
+ * @param stack Stack onde a instrução vai trabalhar
+ */
+void trace_Begin(TraceSpan* span, Stack* stack)
+{
+    int count = stack_Count(stack);
+    span->stack = (uint32_t)count;
+    span->types = trace_p_Type((count > 0) ? stack->array[count - 1] : NULL) |
+        (uint8_t)(trace_p_Type((count > 1) ? stack->array[count - 2] : NULL) << 4);
+    span->depth = (trace_p_depth < 255) ? (uint8_t)trace_p_depth : 255;
+    trace_p_depth++;
+    span->start = profile_Ticks();
+}
+
+/** @brief Acaba uma instrução e escreve o seu evento no buffer da thread.
+ * 
+ * @param trace Apontador para o tracer
+ * @param span Estado dado ao 'trace_Begin'
+ * @param ins Instrução executada
+ */
+void trace_End(Trace* trace, TraceSpan* span, Instruction* ins)
+{
+    long end = profile_Ticks();
+    trace_p_depth--;
+    TraceRing* ring = trace_p_Ring(trace);
+    if (ring == NULL)
+        return;
+    TraceEvent* event = &ring->events[ring->next++ & (trace->capacity - 1)];
+    event->start = (uint64_t)(span->start - trace->startTicks);
+    event->duration = (uint64_t)(end - span->start);
+    event->stack = span->stack;
+    event->pos = ins->pos;
+    event->op = (uint8_t)ins->op;
+    event->cmd = (uint8_t)ins->cmd;
+    event->types = span->types;
+    event->depth = span->depth;
+    event->thread = (uint16_t)trace_p_thread;
+}
+
+/** @brief Escreve os eventos de um buffer, do mais antigo para o mais recente.
+ * 
+ * @param trace Apontador para o tracer
+ * @param ring Buffer de uma thread
+ * @param out Ficheiro onde se escreve
+ */
+void trace_p_SaveRing(Trace* trace, TraceRing* ring, FILE* out)
+{
+    // Se o buffer deu a volta, o mais antigo está onde iria o próximo
+    uint64_t count = (ring->next < trace->capacity) ? ring->next : trace->capacity;
+    uint64_t first = (ring->next - count) & (trace->capacity - 1);
+    uint64_t tail = (first + count > trace->capacity) ? trace->capacity - first : count;
+    fwrite(ring->events + first, sizeof(TraceEvent), tail, out);
+    fwrite(ring->events, sizeof(TraceEvent), count - tail, out);
+}
+
+/** @brief Guarda os eventos num ficheiro, com o texto do programa no fim.
+ * 
+ * Tem que ser chamada depois de todas as threads acabarem de escrever.
+ * 
+ * @param trace Apontador para o tracer
+ * @param program Texto do programa
+ * @param path Caminho do ficheiro
+ * @returns 1 se tiver sucesso
+ */
+int trace_Save(Trace* trace, char* program, char* path)
+{
+    FILE* out = fopen(path, "wb");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Can't write the trace to '%s'\n", path);
+        return 0;
+    }
+    // Os ticks são convertidos com o que passou desde o inicio, medido nas duas unidades
+    long ns = trace_p_Ns() - trace->startNs, ticks = profile_Ticks() - trace->startTicks;
+    double ticksPerSecond = (ns > 0 && ticks > 0) ? ticks * 1e9 / ns : 1e9;
+    int threads = (trace->threads < TraceMaxThreads) ? trace->threads : TraceMaxThreads;
+    uint64_t count = 0, dropped = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        uint64_t n = trace->rings[i]->next;
+        count += (n < trace->capacity) ? n : trace->capacity;
+        dropped += (n < trace->capacity) ? 0 : n - trace->capacity;
+    }
+    uint32_t eventSize = sizeof(TraceEvent), programSize = (uint32_t)strlen(program);
+
+    fwrite(TraceMagic, 1, strlen(TraceMagic), out);
+    fwrite(&ticksPerSecond, sizeof(double), 1, out);
+    fwrite(&count, sizeof(uint64_t), 1, out);
+    fwrite(&dropped, sizeof(uint64_t), 1, out);
+    fwrite(&eventSize, sizeof(uint32_t), 1, out);
+    fwrite(&programSize, sizeof(uint32_t), 1, out);
+    for (int i = 0; i < threads; i++)
+        trace_p_SaveRing(trace, trace->rings[i], out);
+    fwrite(program, 1, programSize, out);
+
+    int ok = !ferror(out);
+    ok = (fclose(out) == 0) && ok;
+    if (!ok)
+        fprintf(stderr, "Can't write the trace to '%s'\n", path);
+    return ok;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file Tracer: guarda cada instrução executada num buffer circular binário, para depois ser convertida pelo trace.py
+ * 
+ * Cada evento é escrito quando a instrução acaba, com o inicio, a duração, o tamanho do stack, os tipos dos
+ * dois items do topo e a profundidade (as instruções executadas dentro de um array ou de um bloco ficam um
+ * nível abaixo da instrução que as executou). Cada thread escreve no seu próprio buffer, e quando este enche os
+ * seus eventos mais antigos são substituídos.
+ * 
+ * Formato do ficheiro (little-endian, como na memória):
+ *   "GSTRACE1"                    8 bytes
+ *   ticks por segundo             double
+ *   eventos guardados             uint64
+ *   eventos perdidos              uint64
+ *   tamanho de cada evento        uint32
+ *   tamanho do programa           uint32
+ *   eventos                       TraceEvent[] (thread a thread, do mais antigo para o mais recente)
+ *   texto do programa             char[]
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "code.h"
+#include "pool.h"
+#include "stack.h"
+
+/** Eventos guardados no buffer de cada thread por omissão */
+#define TraceDefaultEvents (1 << 20)
+/** Quantidade máxima de threads que escrevem (as da pool e a principal) */
+#define TraceMaxThreads (PoolMaxThreads + 1)
+
+/**
+ * Uma instrução executada
+ */
+typedef struct TraceEventT
+{
+    uint64_t start;     /*!< Ticks no inicio */
+    uint64_t duration;  /*!< Ticks do inicio ao fim */
+    uint32_t stack;     /*!< Tamanho do stack no inicio */
+    int32_t pos;        /*!< Posição da instrução no programa (-1 se não tiver) */
+    uint8_t op;         /*!< OpCode */
+    uint8_t cmd;        /*!< Char do comando */
+    uint8_t types;      /*!< Tipos dos items do topo no inicio: o do topo nos 4 bits de baixo, o de baixo dele nos de cima (0 se não há, senão o bit do ItemType + 1) */
+    uint8_t depth;      /*!< Profundidade (0 no programa, +1 dentro de cada array ou bloco, até 255) */
+    uint16_t thread;    /*!< Thread que executou (0 é a primeira a escrever) */
+} TraceEvent;
+
+/**
+ * Buffer circular de uma thread. Só essa thread escreve nele.
+ */
+typedef struct TraceRingT
+{
+    TraceEvent* events; /*!< Buffer com 'capacity' eventos do tracer */
+    uint64_t next;      /*!< Quantidade de eventos escritos até agora (o próximo vai para 'next % capacity') */
+} TraceRing;
+
+/**
+ * Tracer. É partilhado pelo interpretador e pelos seus workers.
+ */
+typedef struct TraceT
+{
+    TraceRing* rings[TraceMaxThreads];  /*!< Buffer de cada thread (criado quando a thread escreve pela primeira vez) */
+    int threads;                        /*!< Quantidade de threads que já escreveram */
+    uint64_t capacity;                  /*!< Tamanho do buffer de cada thread (potência de 2) */
+    long startTicks;                    /*!< Ticks quando o tracer foi criado */
+    long startNs;                       /*!< Nanosegundos quando o tracer foi criado (para converter os ticks) */
+} Trace;
+
+/**
+ * Estado de uma instrução enquanto é executada (fica no stack de quem a executa)
+ */
+typedef struct TraceSpanT
+{
+    long start;         /*!< Ticks no inicio */
+    uint32_t stack;     /*!< Tamanho do stack no inicio */
+    uint8_t types;      /*!< Tipos dos items do topo no inicio */
+    uint8_t depth;      /*!< Profundidade */
+} TraceSpan;
+
+
+/** @brief Cria um tracer vazio.
+ * 
+ * @warning O novo tracer é criado com o "malloc", logo tem que ser libertado depois usando a função 'trace_Dispose'.
+ * @param capacity Quantidade de eventos guardados por thread (arredondada para cima para uma potência de 2)
+ * @returns Novo tracer
+ */
+Trace* trace_Create(uint64_t capacity);
+
+/** @brief Liberta o tracer.
+ * 
+ * @param trace Apontador para o tracer
+ */
+void trace_Dispose(Trace* trace);
+
+/** @brief Começa uma instrução.
+ * 
+ * @param span Estado da instrução
+ * @param stack Stack onde a instrução vai trabalhar
+ */
+void trace_Begin(TraceSpan* span, Stack* stack);
+
+/** @brief Acaba uma instrução e escreve o seu evento no buffer da thread.
+ * 
+ * @param trace Apontador para o tracer
+ * @param span Estado dado ao 'trace_Begin'
+ * @param ins Instrução executada
+ */
+void trace_End(Trace* trace, TraceSpan* span, Instruction* ins);
+
+/** @brief Guarda os eventos num ficheiro, com o texto do programa no fim.
+ * 
+ * Tem que ser chamada depois de todas as threads acabarem de escrever.
+ * 
+ * @param trace Apontador para o tracer
+ * @param program Texto do programa
+ * @param path Caminho do ficheiro
+ * @returns 1 se tiver sucesso
+ */
+int trace_Save(Trace* trace, char* program, char* path);
@@ -0,0 +1,145 @@
+#!/usr/bin/python3
+
+"""
+Converte um trace gravado com "./t --trace FICHEIRO" (ver o trace.h) para:
+- JSON do Chrome Trace Event, para abrir no chrome://tracing ou no https://ui.perfetto.dev
+- stacks "folded", uma linha por caminho com o tempo próprio em nanosegundos, para o flamegraph.pl
+  (https://github.com/brendangregg/FlameGraph) ou o speedscope
+
+As instruções executadas dentro de um array ou de um bloco aparecem dentro da instrução que as executou
+(o '[...]', o '%', o 'w', ...). Se o buffer de uma thread deu a volta, os seus eventos mais antigos
+perderam-se e as instruções cujo pai já não está no trace ficam debaixo de um "?".
+
+Uso:
+    trace.py FICHEIRO [--chrome trace.json] [--folded trace.folded]
+
+Sem --chrome nem --folded escreve só um resumo do trace.
+"""
+
+import argparse
+import collections
+import json
+import struct
+import sys
+
+parser = argparse.ArgumentParser(description = "Converte um trace do interpretador")
+parser.add_argument("trace", help = "ficheiro gravado com --trace")
+parser.add_argument("--chrome", help = "ficheiro JSON para o chrome://tracing")
+parser.add_argument("--folded", help = "ficheiro com as stacks folded para o flamegraph.pl")
+args = parser.parse_args()
+
+magic = b"GSTRACE1"
+header = struct.Struct("<8sdQQII")
+# start, duration, stack, pos, op, cmd, types, depth, thread (o resto do evento é padding)
+event_format = struct.Struct("<QQIiBBBBH")
+
+# Pela mesma ordem do OpCode (code.h) e do ItemType (item.h)
+OP_PUSH, OP_ARRAY, OP_SETVAR, OP_CMD, OP_ECMD = range(5)
+type_names = ["", "long", "double", "char", "string", "list", "block", "repeat"]
+
+
+def read(path):
+    """Lê um trace e devolve (ticks por segundo, eventos perdidos, eventos, texto do programa)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < header.size or data[:len(magic)] != magic:
+        sys.exit("%s: não é um trace (falta o %s)" % (path, magic.decode()))
+    _, ticks_per_second, count, dropped, event_size, program_size = header.unpack_from(data)
+    events = [event_format.unpack_from(data, header.size + i * event_size) for i in range(count)]
+    start = header.size + count * event_size
+    program = data[start:start + program_size].decode("latin-1")
+    return ticks_per_second, dropped, events, program
+
+
+def label(event, program):
+    """Nome de uma instrução, igual ao das tabelas do --profile."""
+    op, cmd, pos = event[4], event[5], event[3]
+    if op == OP_PUSH:
+        first = program[pos] if 0 <= pos < len(program) else ""
+        return {"\"": "\"...\"", "{": "{...}"}.get(first, "number")
+    if op == OP_ARRAY:
+        return "[...]"
+    if op == OP_SETVAR:
+        return ":" + chr(cmd)
+    name = chr(cmd) if 32 < cmd < 127 else "\\x%02x" % cmd
+    return "e" + name if op == OP_ECMD else name
+
+
+def types(event):
+    """Tipos dos dois items do topo do stack (o do topo primeiro)."""
+    names = [type_names[t] if t < len(type_names) else "?" for t in (event[6] & 0xF, event[6] >> 4)]
+    return ",".join(name for name in names if name)
+
+
+def source(event, program):
+    """Inicio do texto do programa na posição da instrução."""
+    pos = event[3]
+    if pos < 0 or pos >= len(program):
+        return ""
+    return program[pos:pos + 16].split("\n")[0]
+
+
+def chrome(events, program, ticks_per_second, path):
+    """Escreve os eventos no formato JSON do Chrome Trace Event (eventos completos, 'ph': 'X')."""
+    us = 1e6 / ticks_per_second
+    out = []
+    for thread in sorted({event[8] for event in events}):
+        out.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": thread, "args": {"name": "thread %d" % thread}})
+    for event in events:
+        out.append({
+            "name": label(event, program), "cat": "vm", "ph": "X", "pid": 1, "tid": event[8],
+            "ts": event[0] * us, "dur": event[1] * us,
+            "args": {"stack": event[2], "types": types(event), "pos": event[3], "source": source(event, program)},
+        })
+    with open(path, "w") as f:
+        json.dump({"traceEvents": out, "displayTimeUnit": "ns"}, f)
+        f.write("\n")
+
+
+def folded(events, program, ticks_per_second, path):
+    """Escreve as stacks folded: o tempo próprio (sem as instruções de dentro) somado por caminho."""
+    ns = 1e9 / ticks_per_second
+    # Cada thread tem a sua árvore; as instruções de dentro começam depois e são mais profundas
+    ordered = sorted(range(len(events)), key = lambda i: (events[i][8], events[i][0], events[i][7]))
+    self_ticks = [event[1] for event in events]
+    paths = [None] * len(events)
+    open_events, thread = [], None
+    for i in ordered:
+        event = events[i]
+        depth = event[7]
+        if event[8] != thread:
+            open_events, thread = [], event[8]
+        # Saem as instruções que já acabaram ou que não podem conter esta
+        while open_events and (events[open_events[-1]][7] >= depth or
+                               sum(events[open_events[-1]][:2]) < event[0]):
+            open_events.pop()
+        parent = open_events[-1] if open_events else None
+        if parent is not None and events[parent][7] == depth - 1:
+            self_ticks[parent] -= event[1]
+            paths[i] = paths[parent] + [label(event, program)]
+        else:
+            # O pai perdeu-se (o buffer deu a volta) ou esta é uma instrução do programa
+            prefix = paths[parent] if parent is not None else []
+            paths[i] = prefix + ["?"] * (depth - len(prefix)) + [label(event, program)]
+        open_events.append(i)
+
+    totals = collections.Counter()
+    for i, event in enumerate(events):
+        totals[(("thread %d" % event[8]),) + tuple(paths[i])] += max(self_ticks[i], 0) * ns
+    with open(path, "w") as f:
+        for stack, value in sorted(totals.items()):
+            if round(value) > 0:
+                f.write("%s %d\n" % (";".join(stack), round(value)))
+
+
+ticks_per_second, dropped, events, program = read(args.trace)
+if dropped:
+    print("%d eventos mais antigos perderam-se (os buffers deram a volta)" % dropped, file = sys.stderr)
+if args.chrome:
+    chrome(events, program, ticks_per_second, args.chrome)
+if args.folded:
+    folded(events, program, ticks_per_second, args.folded)
+if not args.chrome and not args.folded:
+    threads = len({event[8] for event in events})
+    duration = max((event[0] + event[1] for event in events), default = 0) / ticks_per_second
+    print("eventos=%d perdidos=%d threads=%d duração=%.6fs ticks/s=%.0f" % (len(events), dropped, threads, duration, ticks_per_second))
@@ -36,10 +36,19 @@ char* utils_Substring(char* original, int size)
 char* utils_RepeatString(char* original, int size, int times)
 {
     // O +1 é importante porque a string tem que acabar com '\0'
-    char* new = calloc((size * times) + 1, sizeof(char));
-    for (int i = 0; i < times; i++)
-        memcpy(new + (i * size), original, size);
-    new[size * times] = '\0';
+    int total = size * times;
+    char* new = malloc(total + 1);
+    if (total > 0)
+        memcpy(new, original, size);
+    // Copia o que já está preenchido para a frente, duplicando de cada vez
+    int filled = (total > 0) ? size : 0;
+    while (filled < total)
+    {
+        int chunk = (filled < total - filled) ? filled : total - filled;
+        memcpy(new + filled, new, chunk);
+        filled += chunk;
+    }
+    new[total] = '\0';
     return new;
 }
 
@@ -103,17 +112,20 @@ char* utils_StringReplace(char* str, char* sub, char* rep)
 }
 
 
-/** @brief Obtém uma linha da 'stdin'.
+/** @brief Obtém uma linha de um ficheiro.
  * 
+ * @param in Ficheiro de onde se lê (a 'stdin' ou os canais de um programa)
  * @param size Out: O tamanho da string
  * @returns NULL ou a linha
  */
-char* utils_GetLine(int* size)
+char* utils_GetLine(FILE* in, int* size)
 {
-    char* buffer = calloc(DefaultStringBufferSize, sizeof(char));
-    if (fgets(buffer, DefaultStringBufferSize, stdin) != NULL)
+    char* buffer = NULL;
+    size_t capacity = 0;
+    ssize_t length = getline(&buffer, &capacity, in);
+    if (length > 0)
     {
-        *size = strlen(buffer);
+        *size = length;
         // Remove o '\n' no final
         if (buffer[*size - 1] == '\n')
             *size = *size - 1;
@@ -127,15 +139,16 @@ char* utils_GetLine(int* size)
     return NULL;
 }
 
-/** @brief Obtém uma linha da 'stdin'.
+/** @brief Obtém uma linha de um ficheiro.
  * 
  * @warning Esta função utiliza um buffer externo para evitar 'calloc's e 'free's desnecessários
+ * @param in Ficheiro de onde se lê
  * @param size Out: O tamanho da string
  * @returns NULL ou a linha
  */
-char* utils_GetLine_NC(int* size, char* tempBuffer, int tempBufferSize)
+char* utils_GetLine_NC(FILE* in, int* size, char* tempBuffer, int tempBufferSize)
 {
-    if (fgets(tempBuffer, tempBufferSize, stdin) != NULL)
+    if (fgets(tempBuffer, tempBufferSize, in) != NULL)
     {
         *size = strlen(tempBuffer);
         // Remove o '\n' no final
@@ -149,30 +162,38 @@ char* utils_GetLine_NC(int* size, char* tempBuffer, int tempBufferSize)
     return NULL;
 }
 
-/** @brief Obtém várias linhas da 'stdin'.
+/** @brief Obtém todas as linhas que faltam de um ficheiro.
+ * 
+ * O buffer cresce para o dobro quando enche, por isso não há limite para o tamanho do texto.
  * 
+ * @param in Ficheiro de onde se lê
  * @param size Out: O tamanho da string
- * @returns NULL ou a linha
+ * @returns NULL ou as linhas
  */
-char* utils_GetAllLines(int* size)
+char* utils_GetAllLines(FILE* in, int* size)
 {
-    char* buffer = calloc(DefaultStringBufferSize, sizeof(char));
+    int capacity = DefaultStringBufferSize;
+    char* buffer = malloc(capacity + 1);
     int offset = 0;
-    while (fgets(buffer + offset, DefaultStringBufferSize, stdin) != NULL)
+    size_t read;
+    while ((read = fread(buffer + offset, sizeof(char), capacity - offset, in)) > 0)
     {
-        offset += strlen(buffer + offset);
+        offset += read;
+        if (offset == capacity)
+        {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity + 1);
+        }
     }
     *size = offset;
-    buffer[offset] = '\0';
     if (offset == 0)
     {
         free(buffer);
         return NULL;
     }
-    char* s = calloc(offset + 1, sizeof(char));
-    memcpy(s, buffer, offset + 1);
-    free(buffer);
-    return s;
+    buffer[offset] = '\0';
+    // Remove o espaço desperdiçado
+    return realloc(buffer, offset + 1);
 }
 
 
@@ -327,22 +348,31 @@ int utils_StringEquals(char* s1, char* s2)
 int utils_StringCompare(char* a, char* b)
 {
     int i = 0;
-    if (a[0] < b[0])
-        return -1;
-    if (a[0] > b[0])
-        return 1;
     while (a[i] == b[i] && a[i] != '\0')
-    {
-        if (a[i] < b[i])
-            return -1;
-        if (a[i] > b[i])
-            return 1;
         i++;
-    }
+    if (a[i] < b[i])
+        return -1;
+    if (a[i] > b[i])
+        return 1;
     return 0;
 }
 
 
+/** @brief Compara 2 strings com tamanho conhecido.
+ *  
+ * @param s1 String 1
+ * @param size1 Tamanho da string 1
+ * @param s2 String 2
+ * @param size2 Tamanho da string 2
+ * @returns 1 ou 0
+ */
+int utils_StringEqualsN(char* s1, int size1, char* s2, int size2)
+{
+    if (size1 != size2)
+        return 0;
+    return memcmp(s1, s2, size1) == 0;
+}
+
 /** @brief Compara 2 doubles.
  *  
  * @param a Double 1
@@ -357,6 +387,55 @@ int utils_DoubleEquals(double a, double b)
 }
 
 
+/** @brief Calcula o hash (FNV-1a) de um pedaço de memória.
+ *  
+ * @param bytes Apontador para a memória
+ * @param size Quantidade de bytes
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashBytes(char* bytes, int size)
+{
+    unsigned long hash = 14695981039346656037UL;
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211UL;
+    }
+    return (hash != 0) ? hash : 1;
+}
+
+/** @brief Mistura os bits de um número para servir de hash.
+ *  
+ * @param value Número
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashMix(unsigned long value)
+{
+    // Finalizador do splitmix64
+    value += 0x9E3779B97F4A7C15UL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9UL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBUL;
+    value ^= value >> 31;
+    return (value != 0) ? value : 1;
+}
+
+/** @brief Calcula o hash de um double, de forma a que doubles iguais tenham o mesmo hash.
+ *  
+ * @param value Double
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashDouble(double value)
+{
+    // Tudo o que o 'utils_DoubleEquals' considera 0 (incluindo o -0) tem o mesmo hash
+    if (utils_DoubleEquals(value, 0.0))
+        value = 0.0;
+    unsigned long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return utils_HashMix(bits);
+}
+
+
+
 /** @brief Imprime a string na consola, mas pelo número do char separado por vírgulas.
  * 
  * @warning A string não imprime um '\\n' no final.
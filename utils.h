@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stdio.h>
+
 /** Tamanho padrão de uma string grande */
 #define DefaultStringBufferSize 20000
 
@@ -56,27 +58,30 @@ char* utils_StringReplace(char* str, char* sub, char* rep);
 
 
 
-/** @brief Obtém uma linha da 'stdin'.
+/** @brief Obtém uma linha de um ficheiro.
  * 
+ * @param in Ficheiro de onde se lê (a 'stdin' ou os canais de um programa)
  * @param size Out: O tamanho da string
  * @returns NULL ou a linha
  */
-char* utils_GetLine(int* size);
+char* utils_GetLine(FILE* in, int* size);
 
-/** @brief Obtém uma linha da 'stdin'.
+/** @brief Obtém uma linha de um ficheiro.
  * 
  * @warning Esta função utiliza um buffer externo para evitar 'calloc's e 'free's desnecessários
+ * @param in Ficheiro de onde se lê
  * @param size Out: O tamanho da string
  * @returns NULL ou a linha
  */
-char* utils_GetLine_NC(int* size, char* tempBuffer, int tempBufferSize);
+char* utils_GetLine_NC(FILE* in, int* size, char* tempBuffer, int tempBufferSize);
 
-/** @brief Obtém várias linhas da 'stdin'.
+/** @brief Obtém todas as linhas que faltam de um ficheiro.
  * 
+ * @param in Ficheiro de onde se lê
  * @param size Out: O tamanho da string
- * @returns NULL ou a linha
+ * @returns NULL ou as linhas
  */
-char* utils_GetAllLines(int* size);
+char* utils_GetAllLines(FILE* in, int* size);
 
 
 
@@ -167,6 +172,16 @@ int utils_StringEquals(char* s1, char* s2);
  */
 int utils_StringCompare(char* s1, char* s2);
 
+/** @brief Compara 2 strings com tamanho conhecido.
+ *  
+ * @param s1 String 1
+ * @param size1 Tamanho da string 1
+ * @param s2 String 2
+ * @param size2 Tamanho da string 2
+ * @returns 1 ou 0
+ */
+int utils_StringEqualsN(char* s1, int size1, char* s2, int size2);
+
 /** @brief Compara 2 doubles.
  *  
  * @param a Double 1
@@ -178,6 +193,30 @@ int utils_DoubleEquals(double a, double b);
 
 
 
+/** @brief Calcula o hash (FNV-1a) de um pedaço de memória.
+ *  
+ * @param bytes Apontador para a memória
+ * @param size Quantidade de bytes
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashBytes(char* bytes, int size);
+
+/** @brief Mistura os bits de um número para servir de hash.
+ *  
+ * @param value Número
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashMix(unsigned long value);
+
+/** @brief Calcula o hash de um double, de forma a que doubles iguais tenham o mesmo hash.
+ *  
+ * @param value Double
+ * @returns Hash, nunca 0
+ */
+unsigned long utils_HashDouble(double value);
+
+
+
 /** @brief Imprime a string na consola, mas pelo número do char separado por vírgulas.
  * 
  * @warning A string não imprime um '\\n' no final.
@@ -64,11 +64,11 @@ void vars_DebugPrint(Item** vars)
         if (i == 13)
             printf("\n");
         printf("%c: '", II(i));
-        item_Print(vars[i]);
+        item_Print(vars[i], stdout);
         printf("' ");
     }
     printf("%c: '", II(25));
-    item_Print(vars[25]);
+    item_Print(vars[25], stdout);
     printf("' ");
     printf("\n");
 }
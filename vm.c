@@ -0,0 +1,537 @@
+/**
+ * @file Máquina virtual que executa o código compilado pelo parser
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vm.h"
+
+#include "handler_vars.h"
+#include "handler_block.h"
+#include "handler_math.h"
+#include "handler_array.h"
+#include "handler_stack.h"
+#include "handler_logic.h"
+
+
+/** @brief Pede para sair do ciclo atual (o código em execução pára logo a seguir).
+ * 
+ * @param ip Apontador para o interpretador
+ */
+void vm_Break(Interp* ip)
+{ ip->broken = 1; }
+
+/** @brief Verifica se foi pedido para sair do ciclo atual, e limpa o pedido.
+ * 
+ * @param ip Apontador para o interpretador
+ * @returns 1 se foi pedido
+ */
+int vm_TakeBreak(Interp* ip)
+{
+    int r = ip->broken;
+    ip->broken = 0;
+    return r;
+}
+
+/** @brief Esta função é um hub para todas as outras funções que resolvem a entrada
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int handler_Handle(Interp* ip, char cmd)
+{
+    return hHub_Vars(ip, cmd) || hHub_Block(ip, cmd) ||
+    hHub_Math(ip, cmd) || hHub_Stack(ip, cmd) || hHub_Array(ip, cmd) ||
+    hHub_Logic(ip, cmd);
+}
+
+/** @brief Começa um array: o código de dentro passa a correr num stack auxiliar.
+ * 
+ * @param ip Apontador para o interpretador
+ * @returns O stack de fora, para o 'vm_p_LeaveArray'
+ */
+Stack* vm_p_EnterArray(Interp* ip)
+{
+    Stack* stack = ip->stack;
+    ip->stack = interp_TakeStack(ip);
+    return stack;
+}
+
+/** @brief Acaba um array: os items do stack auxiliar passam para uma lista, guardada no stack de fora.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param stack Stack de fora (dado pelo 'vm_p_EnterArray')
+ */
+void vm_p_LeaveArray(Interp* ip, Stack* stack)
+{
+    Stack* newStack = ip->stack;
+    ip->stack = stack;
+    // Os items passam diretamente para a lista, sem serem copiados
+    List* list = list_Create(stack_Count(newStack));
+    stack_MoveToList(newStack, list);
+    stack_Push(stack, icreate_FromList(list));
+    interp_GiveStack(ip, newStack);
+}
+
+/** @brief Executa o código de um array num stack auxiliar e guarda o resultado como lista.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Código de dentro do array
+ * @returns 1 se tiver sucesso
+ */
+int vm_p_Array(Interp* ip, Code* code)
+{
+    Stack* stack = vm_p_EnterArray(ip);
+    vm_Run(ip, code);
+    vm_p_LeaveArray(ip, stack);
+    return 1;
+}
+
+/**
+ * Um hub de handlers, a família a que pertence (para o profiler) e os comandos que aceita
+ */
+typedef struct VmHubT
+{
+    int (*handle)(Interp* ip, char cmd);    /*!< Hub */
+    ProfileHub hub;                         /*!< Família */
+    const char* cmds;                       /*!< Chars que algum handler do hub aceita (todos testam o char antes de mexer no stack) */
+} VmHub;
+
+/** Hubs dos comandos, pela mesma ordem do 'handler_Handle' */
+static const VmHub vm_p_hubs[] =
+{
+    { hHub_Vars, PH_Vars, "ABCDEFGHIJKLMNOPQRSTUVWXYZ" },
+    { hHub_Block, PH_Block, "~?%,*/$wudb" },
+    { hHub_Math, PH_Math, ")(+-*/%#&|^~" },
+    { hHub_Stack, PH_Stack, "_;\\@$ltpifcs" },
+    { hHub_Array, PH_Array, "~+*,=#()<>/$|&-n" },
+    { hHub_Logic, PH_Logic, "=<>!?" },
+};
+
+/** Hubs dos comandos que começam por 'e', pela mesma ordem */
+static const VmHub vm_p_eHubs[] =
+{
+    { hHub_EBlock, PH_EBlock, "&|" }, { hHub_ELogic, PH_ELogic, "&|<>" }, { hHub_EVars, PH_EVars, "m" },
+};
+
+// Para cada char, os hubs que o podem aceitar (um bit por indice nas tabelas acima), preenchidos uma vez
+static unsigned char vm_p_cmdHubs[256], vm_p_eCmdHubs[256];
+// Comandos que o 'vm_p_FastMath' pode fazer (1 ou 0), para os outros nem olharem para o stack
+static unsigned char vm_p_fastCmds[256];
+static pthread_once_t vm_p_dispatchOnce = PTHREAD_ONCE_INIT;
+
+/** @brief Preenche os hubs que podem aceitar cada char a partir dos 'cmds' de uma tabela.
+ * 
+ * @param hubs Hubs
+ * @param n Quantidade de hubs
+ * @param cmdHubs Out: bits dos hubs de cada char
+ */
+void vm_p_FillDispatch(const VmHub* hubs, int n, unsigned char* cmdHubs)
+{
+    for (int i = 0; i < n; i++)
+        for (const char* c = hubs[i].cmds; *c != '\0'; c++)
+            cmdHubs[(unsigned char)*c] |= 1 << i;
+}
+
+/** @brief Preenche as tabelas de despacho dos comandos (chamada uma vez, pelo 'pthread_once').
+ */
+void vm_p_BuildDispatch()
+{
+    vm_p_FillDispatch(vm_p_hubs, sizeof(vm_p_hubs) / sizeof(VmHub), vm_p_cmdHubs);
+    vm_p_FillDispatch(vm_p_eHubs, sizeof(vm_p_eHubs) / sizeof(VmHub), vm_p_eCmdHubs);
+    for (const char* c = ")(+-*<>="; *c != '\0'; c++)
+        vm_p_fastCmds[(unsigned char)*c] = 1;
+}
+
+/** @brief Avisa que um comando não foi tratado por nenhum handler.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução
+ */
+void vm_p_Unhandled(Interp* ip, Instruction* ins)
+{
+    // debug
+    if (ins->cmd > 10)
+        fprintf(ip->io.out, "Can't handle command '%d'\n", (ins->op == OP_ECmd) ? 'e' : ins->cmd);
+}
+
+/** @brief Passa um comando pelos hubs que o podem aceitar até um o tratar, guardando qual foi.
+ * 
+ * Os hubs são tentados pela ordem da tabela, como no 'handler_Handle', mas os que não têm nenhum
+ * handler para este char são saltados.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param hubs Tabela dos hubs
+ * @param mask Bits dos hubs a tentar (do 'vm_p_cmdHubs' ou do 'vm_p_eCmdHubs')
+ * @param cmd Char do comando
+ * @param hub Out: família do hub que tratou o comando (PH_None se nenhum tratou), ou NULL
+ * @returns 1 se tiver sucesso
+ */
+int vm_p_HandleHubs(Interp* ip, const VmHub* hubs, unsigned mask, char cmd, ProfileHub* hub)
+{
+    for (; mask != 0; mask &= mask - 1)
+    {
+        const VmHub* h = &hubs[__builtin_ctz(mask)];
+        if (h->handle(ip, cmd))
+        {
+            if (hub != NULL)
+                *hub = h->hub;
+            return 1;
+        }
+    }
+    if (hub != NULL)
+        *hub = PH_None;
+    return 0;
+}
+
+/** @brief Executa um comando, avisando se nenhum handler o tratou.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução (OP_Cmd ou OP_ECmd)
+ * @param hubs Tabela dos hubs ('vm_p_hubs' ou 'vm_p_eHubs')
+ * @param cmdHubs Bits dos hubs de cada char ('vm_p_cmdHubs' ou 'vm_p_eCmdHubs')
+ * @param hub Out: família do hub que tratou o comando, ou NULL (sem o profiler não é preciso)
+ * @returns 1 se tiver sucesso
+ */
+int vm_p_Command(Interp* ip, Instruction* ins, const VmHub* hubs, const unsigned char* cmdHubs, ProfileHub* hub)
+{
+    int r = vm_p_HandleHubs(ip, hubs, cmdHubs[(unsigned char)ins->cmd], ins->cmd, hub);
+    if (!r)
+        vm_p_Unhandled(ip, ins);
+    return r;
+}
+
+/** @brief Faz as contas mais comuns diretamente no stack, quando os items do topo são longs.
+ * 
+ * Os dois items do topo ficam em variáveis locais e o resultado é escrito no item do topo, sem os tirar do stack
+ * nem passar pelos hubs. Dá sempre o mesmo resultado que os handlers (as comparações também são feitas em double);
+ * com outros tipos ou outros comandos não mexe em nada e o comando segue para os hubs.
+ * 
+ * @param stack Apontador para o stack
+ * @param cmd Char do comando
+ * @returns 1 se fez a conta
+ */
+int vm_p_FastMath(Stack* stack, char cmd)
+{
+    int p = stack->pointer;
+    if (p < 0 || stack->array[p] == NULL || stack->array[p]->type != TLong)
+        return 0;
+    long* b = (long*)stack->array[p]->pointer;
+    if (cmd == ')' || cmd == '(')
+    {
+        *b += (cmd == ')') ? 1 : -1;
+        return 1;
+    }
+    if (p < 1 || stack->array[p - 1] == NULL || stack->array[p - 1]->type != TLong)
+        return 0;
+    long a = *(long*)stack->array[p - 1]->pointer;
+    switch (cmd)
+    {
+        case '+': *b = a + *b; break;
+        case '-': *b = a - *b; break;
+        case '*': *b = a * *b; break;
+        case '<': *b = (double)a < (double)*b; break;
+        case '>': *b = (double)a > (double)*b; break;
+        case '=': *b = a == *b; break;
+        default: return 0;
+    }
+    // O resultado fica no lugar do primeiro
+    item_Dispose(stack->array[p - 1]);
+    stack->array[p - 1] = stack->array[p];
+    stack->array[p] = NULL;
+    stack->pointer--;
+    return 1;
+}
+
+/** @brief Executa uma instrução, sem contar nem medir.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução
+ * @returns 1 se tiver sucesso
+ */
+int vm_p_Step(Interp* ip, Instruction* ins)
+{
+    ProfileHub hub;
+    switch (ins->op)
+    {
+        case OP_Push:
+            stack_Push(ip->stack, item_Copy(ins->value));
+            return 1;
+        case OP_Array:
+            return vm_p_Array(ip, ins->sub);
+        case OP_SetVar:
+            return h_v_SetValue(ip, ins->cmd);
+        case OP_ECmd:
+            return vm_p_Command(ip, ins, vm_p_eHubs, vm_p_eCmdHubs, &hub);
+        default:
+            return vm_p_Command(ip, ins, vm_p_hubs, vm_p_cmdHubs, &hub);
+    }
+}
+
+/** @brief Executa uma instrução medindo-a com o profiler e/ou guardando-a no tracer (os que estiverem ligados).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução
+ * @returns 1 se tiver sucesso
+ */
+int vm_p_InstrumentedStep(Interp* ip, Instruction* ins)
+{
+    ProfileFrame frame;
+    TraceSpan span;
+    ProfileHub hub = PH_Vm;
+    int r;
+    if (ip->profile != NULL)
+        profile_Begin(&frame);
+    if (ip->trace != NULL)
+        trace_Begin(&span, ip->stack);
+    switch (ins->op)
+    {
+        case OP_Push:
+            stack_Push(ip->stack, item_Copy(ins->value));
+            r = 1;
+            break;
+        case OP_Array:
+            r = vm_p_Array(ip, ins->sub);
+            break;
+        case OP_SetVar:
+            r = h_v_SetValue(ip, ins->cmd);
+            break;
+        case OP_ECmd:
+            r = vm_p_Command(ip, ins, vm_p_eHubs, vm_p_eCmdHubs, &hub);
+            break;
+        default:
+            r = vm_p_Command(ip, ins, vm_p_hubs, vm_p_cmdHubs, &hub);
+            break;
+    }
+    if (ip->trace != NULL)
+        trace_End(ip->trace, &span, ins);
+    if (ip->profile != NULL)
+        profile_End(ip->profile, &frame, ins, hub);
+    return r;
+}
+
+/** @brief Executa uma instrução.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução
+ * @returns 1 se tiver sucesso
+ */
+int vm_Step(Interp* ip, Instruction* ins)
+{
+    pthread_once(&vm_p_dispatchOnce, vm_p_BuildDispatch);
+    ip->stats.instructions++;
+    // Sem amostras o 'nextSample' é LONG_MAX, por isso custa só uma comparação
+    // (as instruções dos workers de um map só são somadas no fim, por isso a próxima conta a partir de agora)
+    if (ip->stats.instructions >= ip->nextSample)
+    {
+        ip->nextSample = ip->stats.instructions + ip->sampleEvery;
+        interp_PrintMemory(ip, stderr);
+    }
+    if (ip->profile != NULL || ip->trace != NULL)
+        return vm_p_InstrumentedStep(ip, ins);
+    return vm_p_Step(ip, ins);
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VM_SWITCH)
+
+// Os endereços das labels ('&&label') e o 'goto *' são uma extensão do GCC e do clang
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+/** Passa para a próxima instrução (ou sai): cada instrução acaba com o seu próprio salto indireto */
+#define VM_NEXT() \
+    do { \
+        if (++ins == end || ip->broken) \
+            return r; \
+        ip->stats.instructions++; \
+        goto *labels[ins->op]; \
+    } while (0)
+
+/** Passa para a próxima instrução depois de um comando, que pode começar um bloco básico (ver o 'code_Add') */
+#define VM_NEXT_BLOCK() \
+    do { \
+        if (++ins == end || ip->broken) \
+            return r; \
+        ip->stats.instructions++; \
+        if (ins->reserve > 0) \
+            stack_Reserve(ip->stack, ins->reserve); \
+        goto *labels[ins->op]; \
+    } while (0)
+
+/** @brief Executa um código compilado, saltando diretamente de uma instrução para o código da seguinte (computed goto).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução
+ */
+int vm_p_RunCode(Interp* ip, Code* code)
+{
+    // Pela mesma ordem do OpCode
+    static void* const labels[] = { &&push, &&array, &&setVar, &&cmd, &&eCmd };
+    Instruction* ins = code->array, *end = code->array + code->count;
+    Stack* stack;
+    int r = 0;
+    if (ins == end || ip->broken)
+        return r;
+    ip->stats.instructions++;
+    if (ins->reserve > 0)
+        stack_Reserve(ip->stack, ins->reserve);
+    goto *labels[ins->op];
+push:
+    // O espaço foi reservado no inicio do bloco básico
+    stack = ip->stack;
+    stack->array[++stack->pointer] = item_Copy(ins->value);
+    r = 1;
+    VM_NEXT();
+array:
+    // Sem passar pelo 'vm_p_Array', para cada nível de arrays dentro de arrays gastar só o stack do C desta função
+    stack = vm_p_EnterArray(ip);
+    vm_Run(ip, ins->sub);
+    vm_p_LeaveArray(ip, stack);
+    r = 1;
+    VM_NEXT();
+setVar:
+    r = h_v_SetValue(ip, ins->cmd);
+    VM_NEXT();
+cmd:
+    r = (vm_p_fastCmds[(unsigned char)ins->cmd] && vm_p_FastMath(ip->stack, ins->cmd)) ||
+        vm_p_Command(ip, ins, vm_p_hubs, vm_p_cmdHubs, NULL);
+    VM_NEXT_BLOCK();
+eCmd:
+    r = vm_p_Command(ip, ins, vm_p_eHubs, vm_p_eCmdHubs, NULL);
+    VM_NEXT_BLOCK();
+}
+
+#pragma GCC diagnostic pop
+
+#else
+
+/** @brief Executa um código compilado, com um switch em cada instrução (sem o computed goto, ou com -DVM_SWITCH).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução
+ */
+int vm_p_RunCode(Interp* ip, Code* code)
+{
+    Stack* stack;
+    int r = 0;
+    for (Instruction* ins = code->array, *end = code->array + code->count; ins < end && !ip->broken; ins++)
+    {
+        ip->stats.instructions++;
+        // Só a primeira instrução de cada bloco básico tem 'reserve' (ver o 'code_Add')
+        if (ins->reserve > 0)
+            stack_Reserve(ip->stack, ins->reserve);
+        switch (ins->op)
+        {
+            case OP_Push:
+                stack = ip->stack;
+                stack->array[++stack->pointer] = item_Copy(ins->value);
+                r = 1;
+                break;
+            case OP_Array:
+                // Como no computed goto, sem o 'vm_p_Array' no meio da recursão
+                stack = vm_p_EnterArray(ip);
+                vm_Run(ip, ins->sub);
+                vm_p_LeaveArray(ip, stack);
+                r = 1;
+                break;
+            case OP_SetVar:
+                r = h_v_SetValue(ip, ins->cmd);
+                break;
+            case OP_ECmd:
+                r = vm_p_Command(ip, ins, vm_p_eHubs, vm_p_eCmdHubs, NULL);
+                break;
+            default:
+                r = (vm_p_fastCmds[(unsigned char)ins->cmd] && vm_p_FastMath(ip->stack, ins->cmd)) ||
+                    vm_p_Command(ip, ins, vm_p_hubs, vm_p_cmdHubs, NULL);
+                break;
+        }
+    }
+    return r;
+}
+
+#endif
+
+/** @brief Executa um código compilado instrução a instrução pelo 'vm_Step' (com o profiler, o tracer ou as amostras).
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução
+ */
+int vm_p_RunSteps(Interp* ip, Code* code)
+{
+    int r = 0;
+    // Um 'b' pára o código todo até chegar ao ciclo
+    for (Instruction* ins = code->array, *end = code->array + code->count; ins < end && !ip->broken; ins++)
+        r = vm_Step(ip, ins);
+    return r;
+}
+
+/** @brief Executa um código compilado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução, não tem grande uso
+ */
+int vm_Run(Interp* ip, Code* code)
+{
+    ip->stats.runs++;
+    // O profiler, o tracer e as amostras da memória vêem cada instrução, por isso passam pelo 'vm_Step'
+    // (fica noutra função para a recursão dos arrays e blocos dentro de outros gastar menos stack do C)
+    if (ip->profile != NULL || ip->trace != NULL || ip->nextSample != LONG_MAX)
+        return vm_p_RunSteps(ip, code);
+    pthread_once(&vm_p_dispatchOnce, vm_p_BuildDispatch);
+    return vm_p_RunCode(ip, code);
+}
+
+/** @brief Calcula o char que deu origem a uma instrução.
+ * 
+ * @param ins Apontador para a instrução
+ * @returns Char do código original
+ */
+char vm_p_SourceChar(Instruction* ins)
+{
+    if (ins->op == OP_Array)
+        return '[';
+    if (ins->op == OP_SetVar)
+        return ':';
+    if (ins->op == OP_ECmd)
+        return 'e';
+    if (ins->op == OP_Push)
+        return (ins->value->type == TBlock) ? '{' : '\"';
+    return ins->cmd;
+}
+
+/** @brief Executa um código compilado imprimindo detalhes sobre cada passo
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução, não tem grande uso
+ */
+int vm_DebugRun(Interp* ip, Code* code)
+{
+    FILE* out = ip->io.out;
+    int r = 0;
+    for (int i = 0; i < code->count && !ip->broken; i++)
+    {
+        Instruction* ins = &code->array[i];
+        r = vm_Step(ip, ins);
+        if (ins->op == OP_Push && item_IsType(ins->value, IT_Num))
+            fprintf(out, "N: '%lg'\n", i_ToDouble(ins->value));
+        else if (r)
+        {
+            char* is = i_ToString(stack_Peek(ip->stack));
+            fprintf(out, "C: '%c': '%s'\n", vm_p_SourceChar(ins), is);
+            free(is);
+        }
+        stack_PrintWS(ip->stack, out);
+        fprintf(out, "\n\n");
+    }
+    return r;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file Máquina virtual que executa o código compilado pelo parser
+ */
+
+#pragma once
+
+#include "code.h"
+#include "interp.h"
+
+
+/** @brief Esta função é um hub para todas as outras funções que resolvem a entrada
+ * 
+ * @param ip Apontador para o interpretador
+ * @param cmd Char do comando
+ * @returns 1 se tiver sucesso
+ */
+int handler_Handle(Interp* ip, char cmd);
+
+/** @brief Executa uma instrução.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param ins Apontador para a instrução
+ * @returns 1 se tiver sucesso
+ */
+int vm_Step(Interp* ip, Instruction* ins);
+
+/** @brief Executa um código compilado.
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução, não tem grande uso
+ */
+int vm_Run(Interp* ip, Code* code);
+
+/** @brief Pede para sair do ciclo atual (o código em execução pára logo a seguir).
+ * 
+ * @param ip Apontador para o interpretador
+ */
+void vm_Break(Interp* ip);
+
+/** @brief Verifica se foi pedido para sair do ciclo atual, e limpa o pedido.
+ * 
+ * @param ip Apontador para o interpretador
+ * @returns 1 se foi pedido
+ */
+int vm_TakeBreak(Interp* ip);
+
+/** @brief Executa um código compilado imprimindo detalhes sobre cada passo
+ * 
+ * @param ip Apontador para o interpretador
+ * @param code Apontador para o código
+ * @returns O resultado da ultima instrução, não tem grande uso
+ */
+int vm_DebugRun(Interp* ip, Code* code);